@@ -0,0 +1,46 @@
+// arena.h
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <SDL2/SDL.h>
+
+// Bump allocator for match-lifetime memory. One contiguous block is reserved
+// when the arena is created; allocating only moves an offset forward and
+// nothing is freed on its own. arena_reset hands the whole block back in
+// O(1) when the match ends, so a long-running server reuses the same memory
+// for every match and never touches the shared heap while one runs.
+#define ARENA_ALIGN 16
+
+typedef struct Arena Arena;
+
+// Debug counters, exact memory accounting for one match
+typedef struct {
+    size_t capacity;        // Bytes in the block
+    size_t used;            // Handed out since the last reset, alignment padding included
+    size_t peak;            // Highest used since the arena was created
+    Uint32 allocations;     // Since the last reset
+    Uint32 failed;          // Requests that did not fit, since creation
+} ArenaStats;
+
+/**
+ * @brief Reserves the block.
+ * @return The arena, or NULL if the block could not be allocated.
+ */
+Arena *arena_create(size_t capacity);
+void arena_destroy(Arena *arena);
+
+/**
+ * @brief Zeroed, ARENA_ALIGN aligned memory, valid until the next reset.
+ * @return The memory, or NULL when the arena is full.
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * @brief Releases every allocation at once.
+ */
+void arena_reset(Arena *arena);
+
+ArenaStats arena_stats(const Arena *arena);
+
+#endif // ARENA_H
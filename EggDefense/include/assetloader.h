@@ -0,0 +1,59 @@
+// assetloader.h
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include "defs.h"
+
+// Decodes asset files on a pool of worker threads. Only the CPU part runs
+// there (PNG to an RGBA32 surface, WAV/MP3 to Mix_Chunk/Mix_Music); turning
+// surfaces into textures needs the renderer and stays on the calling thread.
+// Startup then takes about as long as the slowest single asset instead of
+// the sum of all of them.
+typedef struct AssetLoader AssetLoader;
+
+typedef enum {
+    ASSET_IMAGE,    // SDL_Surface*, SDL_PIXELFORMAT_RGBA32
+    ASSET_SOUND,    // Mix_Chunk*
+    ASSET_MUSIC     // Mix_Music*
+} AssetKind;
+
+AssetLoader *asset_loader_create(void);
+
+/**
+ * @brief Waits for the workers and frees every result that was not taken.
+ */
+void asset_loader_destroy(AssetLoader *loader);
+
+/**
+ * @brief Queues a file. Only allowed before asset_loader_start.
+ * @return Job id for the calls below, or -1 on failure.
+ */
+int asset_loader_add(AssetLoader *loader, AssetKind kind, const char *path);
+
+/**
+ * @brief Starts decoding. numWorkers <= 0 uses one worker per CPU core, at
+ * most ASSET_LOADER_MAX_WORKERS. If no thread can be created the jobs are
+ * decoded by asset_loader_wait_next on the calling thread instead.
+ */
+void asset_loader_start(AssetLoader *loader, int numWorkers);
+
+/**
+ * @brief Blocks until at least one more job has finished.
+ * @return Number of finished jobs, equal to asset_loader_count when all are done.
+ */
+int asset_loader_wait_next(AssetLoader *loader);
+
+int asset_loader_count(const AssetLoader *loader);
+bool asset_loader_done(AssetLoader *loader, int job);
+
+/**
+ * @brief Hands the decoded asset of a finished job to the caller.
+ * @return The surface, chunk or music (cast to the job's kind), or NULL if
+ * the job failed, is not finished or was already taken.
+ */
+void *asset_loader_take(AssetLoader *loader, int job);
+
+#endif // ASSETLOADER_H
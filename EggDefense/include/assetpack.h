@@ -0,0 +1,70 @@
+// assetpack.h
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include "defs.h"
+
+// Single-file asset archive written by the packer tool (make pack). Images
+// are stored already decoded as RGBA32 pixels, the font and audio as the raw
+// file bytes. At runtime the file is mapped (one sequential read on Windows)
+// and textures are created straight from the mapped pixels: no PNG decoding
+// and no per-file opens.
+//
+// Layout: AssetPackHeader, numEntries AssetPackEntry, then the blobs, each
+// starting on an ASSET_PACK_ALIGN boundary. Native byte order, the pack is
+// built on the machine (class) it runs on.
+#define ASSET_PACK_MAGIC 0x4B415045u // "EPAK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_NAME_SIZE 64
+#define ASSET_PACK_ALIGN 16
+
+typedef enum {
+    ASSET_PACK_RAW  = 0,    // File bytes as-is (font, audio)
+    ASSET_PACK_RGBA = 1     // SDL_PIXELFORMAT_RGBA32 pixels, pitch = width * 4
+} AssetPackKind;
+
+typedef struct {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 numEntries;
+    Uint32 reserved;
+} AssetPackHeader;
+
+typedef struct {
+    char name[ASSET_PACK_NAME_SIZE]; // Path it was packed from, e.g. "resources/map.png"
+    Uint32 kind;
+    Uint32 width, height;   // ASSET_PACK_RGBA only
+    Uint32 offset;          // From the start of the file
+    Uint32 size;            // Bytes
+    Uint32 reserved[3];
+} AssetPackEntry;
+
+typedef struct AssetPack AssetPack;
+
+/**
+ * @brief Maps an archive. Everything returned below points into it, so the
+ * pack must stay open while textures are created, and as long as the font
+ * and music streamed from it are in use.
+ * @return The pack, or NULL if the file is missing or not a valid pack.
+ */
+AssetPack *asset_pack_open(const char *path);
+void asset_pack_close(AssetPack *pack);
+
+const AssetPackEntry *asset_pack_find(const AssetPack *pack, const char *name);
+
+/**
+ * @brief RGBA32 surface over the packed pixels (no copy). Freeing it does
+ * not touch the pack.
+ * @return The surface, or NULL if the image is not in the pack.
+ */
+SDL_Surface *asset_pack_surface(const AssetPack *pack, const char *name);
+
+/**
+ * @brief Read-only stream over a packed file, for IMG/Mix/TTF *_RW loaders.
+ * @return The stream, or NULL if the file is not in the pack.
+ */
+SDL_RWops *asset_pack_rw(const AssetPack *pack, const char *name);
+
+#endif // ASSETPACK_H
@@ -0,0 +1,47 @@
+// atlas.h
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include "defs.h"
+
+// A sprite is a rect in a shared atlas page. w and h are the size of the
+// original image, which the render scale constants are relative to.
+typedef struct {
+    SDL_Texture *texture;   // Atlas page, NULL if the image failed to load
+    SDL_Rect src;           // Where the sprite lives in the page
+    int w, h;               // Original image size
+} Sprite;
+
+// Packs many small images into one or a few atlas pages at load time, so all
+// gameplay sprites can be drawn from the same texture in one batch. Images
+// larger than ATLAS_MAX_SPRITE_SIZE are downscaled (linear) while packing;
+// they are only ever drawn much smaller than their source size anyway.
+typedef struct AtlasBuilder AtlasBuilder;
+
+AtlasBuilder *atlas_builder_create(void);
+void atlas_builder_destroy(AtlasBuilder *builder);
+
+/**
+ * @brief Loads an image and queues it for packing. *out is filled in by
+ * atlas_builder_build, so it must stay valid until then.
+ * @return false if the image could not be loaded.
+ */
+bool atlas_builder_add(AtlasBuilder *builder, const char *path, Sprite *out);
+
+/**
+ * @brief Same as atlas_builder_add for an image that is already decoded
+ * (e.g. by the asset loader). Takes ownership of the surface, also on failure.
+ * @return false if the surface is NULL or not SDL_PIXELFORMAT_RGBA32.
+ */
+bool atlas_builder_add_surface(AtlasBuilder *builder, SDL_Surface *rgba, Sprite *out);
+
+/**
+ * @brief Packs all queued images (shelf packing, tallest first), uploads the
+ * pages and fills in every queued Sprite. The caller owns the pages.
+ * @return Number of pages created (at most maxPages), 0 on failure.
+ */
+int atlas_builder_build(AtlasBuilder *builder, SDL_Renderer *renderer, SDL_Texture **pages, int maxPages);
+
+#endif // ATLAS_H
@@ -29,9 +29,34 @@ typedef enum { //Team
 #define MAX_PLAYERS 4
 #define PACKET_BUFFER_SIZE 8192
 #define GAME_TICK_RATE 60
-#define CLIENT_HEARTBEAT_INTERVAL 2000
+#define SINGLEPLAYER_SIM_RATE GAME_TICK_RATE // fixed simulation steps per second, rendering interpolates between them
+#define SINGLEPLAYER_MAX_FRAME_TIME 0.25f // seconds of simulation caught up per frame at most
+#define RENDER_INPUT_QUEUE_SIZE 128 // input events queued from the render thread to the logic thread
+#define CLIENT_HEARTBEAT_INTERVAL 250 // also the RTT sampling rate
 #define CLIENT_READY_INTERVAL 500
 #define SERVER_CLIENT_TIMEOUT 10000
+#define TRANSPORT_BATCH_SIZE 32 // datagrams per recvmmsg/sendmmsg call
+#define NET_MTU_PAYLOAD 1200 // safe UDP payload size, keeps datagrams below IP fragmentation
+#define FRAGMENT_MAX_COUNT 32 // max fragments per message
+#define FRAGMENT_REASSEMBLY_SLOTS 4 // messages being reassembled at once
+#define FRAGMENT_TIMEOUT_MS 200 // give up on missing fragments after this
+#define LOCAL_LINK_RING_SIZE 64 // queued commands between host client and server thread
+#define LOCAL_LINK_SLOT_SIZE 64 // max bytes per local (non-snapshot) message
+#define NETSTATS_CSV_INTERVAL 1000 // ms between rows while exporting network stats
+#define NETCOND_QUEUE_SIZE 128 // datagrams held back by one network conditioner
+#define NETCOND_REORDER_HOLD_MS 40 // extra delay for datagrams picked for reordering
+#define MAX_SPECTATORS 8 // direct spectators per server, use a relay for more
+#define SPECTATOR_TICK_DIVISOR 4 // spectators get every 4th tick (15 Hz)
+#define SPECTATOR_KEYFRAME_INTERVAL 15 // frames between full snapshots in the spectator stream
+#define SPECTATOR_KEEPALIVE_INTERVAL 1000 // ms between SPECTATE packets from a viewer
+#define RELAY_PORT 9998
+#define RELAY_MAX_SPECTATORS 512
+#define SERVER_IDLE_TICK_MS 100 // server wakeup interval while no match is running
+#define SERVER_MAX_CATCHUP_TICKS 6 // ticks simulated in one wakeup after falling behind (0.1 s), the rest is dropped
+#define SNAPSHOT_STATE_HASH 1 // 1 = snapshots carry a checksum the receiver verifies (see snapshot.h)
+#define MATCH_ARENA_SIZE (256 * 1024) // bytes, server per-match arena (see arena.h)
+#define SAVESTATE_CHECKPOINT_INTERVAL (GAME_TICK_RATE * 10) // ticks between EGG_CHECKPOINT save states
+#define REPLAY_KEYFRAME_INTERVAL (GAME_TICK_RATE * 5) // ticks between full states in a replay, the most a seek simulates
 
 // Rendering Constants
 #define BIRD_RENDER_SCALE 0.30f // Doubled tower render size
@@ -40,9 +65,23 @@ typedef enum { //Team
 // #define PROJECTILE_RENDER_SCALE 0.1f // Original value
 #define PROJECTILE_RENDER_SCALE 1.0f // Set to 100% size for testing
 #define ICON_SCALE_DIVISOR 3
+#define HP_BAR_WIDTH (int)(WINDOW_WIDTH * 0.1f)
+#define HP_BAR_HEIGHT (int)(WINDOW_HEIGHT * 0.02f)
+#define HP_BAR_Y 40 // 30px under the top HUD line
+#define HP_BAR_MARGIN_X 50
+#define SPRITEBATCH_MAX_TEXTURES 8 // distinct textures queued before the sprite batch flushes
+#define ATLAS_PAGE_SIZE 2048 // width and max height of one sprite atlas page
+#define ATLAS_MAX_PAGES 4
+#define ATLAS_MAX_SPRITE_SIZE 256 // longer sides are downscaled when packed
+#define ATLAS_PADDING 2 // transparent pixels between packed sprites
+#define TEXT_CACHE_SIZE 64 // rendered strings kept per renderer
+#define TEXT_CACHE_MAX_TEXT 192 // longer strings are not cached
+#define ASSET_LOADER_MAX_WORKERS 8 // threads decoding asset files at startup
+#define ASSET_PACK_PATH "resources/assets.pak" // pre-decoded asset archive (make pack), loose files are used without it
 
 // Path Definition
 #define NUM_POINTS 15
+#define BIRD_MAX_COVER 6 // path intervals inside one tower's range (the current paths need at most 4)
 
 // Ensure M_PI is defined
 #ifndef M_PI
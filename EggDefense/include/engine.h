@@ -15,6 +15,18 @@
 #include "defs.h"
 #include "paths.h"
 #include "network.h"
+#include "transport.h"
+#include "fragment.h"
+#include "netstats.h"
+#include "netcond.h"
+#include "spectate.h"
+#include "tickloop.h"
+#include "spritebatch.h"
+#include "atlas.h"
+#include "textcache.h"
+#include "interp.h"
+#include "assetpack.h"
+#include "arena.h"
 
 // Global Game State Enum
 typedef enum {
@@ -31,27 +43,32 @@ typedef enum {
     MODE_CLIENT
 } BuildMode;
 
+// Entities and GameState below hold no pointers: sprites, paths and tower
+// stats live in GameResources and are referred to by index, so a whole
+// match state copies with one memcpy (render frames, rollback, save states).
+
 // projectile 
 typedef struct {
+    Uint32 id;            // Unique per match, for render interpolation
     float x, y;           // Current position
     float vx, vy;           // Velocity vector (normalized direction)
-    SDL_Texture *texture;   // Texture to render
-    int textureIndex;     // 0=dart, 1=bullet
+    int textureIndex;     // projectileSprites index, 0=dart, 1=bullet
     bool active;          // Is the projectile currently in flight?
     float angle;          // Angle for rotation
 } Projectile;
 
 // enemy 
 typedef struct {
+    Uint32 id;            // Unique per match, for render interpolation
     int hp;               // Current health points
     float speed;          // Movement speed 
     float x, y;           // Current position
     int currentSegment;   // Index of the path segment currently on
     float segmentProgress;// Progress along the current segment (0.0 to 1.0)
-    SDL_Texture *texture;   // Texture to render (can change based on HP/type)
+    int spriteIndex;      // enemySprites index (steps down with HP)
     int type;             // Type of enemy (0=red, 1=blue, 2=yellow)
     bool active;          // Is the enemy currently on the map?
-    int side;             // Which path, 0 = left, 1 = right
+    int side;             // Which path in GameResources.paths, 0 = left, 1 = right
     float angle;          // Angle for rotation (based on path direction)
 } Enemy;
 
@@ -61,24 +78,25 @@ typedef struct {
     float range;            // Attack radius
     float attackSpeed;      // Attacks per second
     int cost;               // Cost to place
-    SDL_Texture *projectileTexture; // Which projectile texture to use
-    int projectileTextureIndex; // 0=dart, 1=bullet
+    int projectileTextureIndex; // projectileSprites index, 0=dart, 1=bullet
     float x, y;             // Position on map
     bool active;            // Is this tower slot used?
     float attackTimer;      // Time since last attack
     float attackAnimTimer;  // Timer for showing attack animation frame
     float rotation;         // Current rotation angle
-    SDL_Texture *texture;       // Current texture (base or attack)
-    SDL_Texture *baseTexture;   // base appearance
-    SDL_Texture *attackTexture; // attack Appearance
     int ownerPlayerIndex;   // Which player owns this tower (-1 if singleplayer)
-    int towerTypeIndex;     // Index for networking/identification (0=super, 1=bat, 2=brown)
+    int towerTypeIndex;     // Index for networking and into towerOptions/tower*Sprites (0=super, 1=bat, 2=brown)
+    int damageDealt;        // HP actually removed from enemies this match (balance statistics)
+    bool hasCover;          // cover is valid, otherwise targeting measures distances
+    Uint8 coverSide;        // The lane (Enemy.side) the tower shoots at
+    Uint8 numCover;
+    PathInterval cover[BIRD_MAX_COVER]; // Path progress inside range, set once by place_tower
 } Bird;
 
 // selectable tower option in the UI
 typedef struct {
-    Bird prototype;         // Base stats and textures for this tower type
-    SDL_Texture *iconTexture; // Texture for the UI button
+    Bird prototype;         // Base stats for this tower type
+    const Sprite *iconSprite; // Sprite for the UI button
     SDL_Rect iconRect;        // Position and size of the UI button
 } TowerOption;
 
@@ -89,28 +107,47 @@ typedef struct {
     Mix_Music *bgm;      // Background music
 } Audio;
 
+// Map, tower shadows and HUD frame baked into a render target. Rebuilt only
+// when a tower is placed or the set of affordable towers changes.
+typedef struct {
+    SDL_Texture *texture;   // NULL if render targets are unsupported
+    bool valid;
+    Uint32 towerVersion;    // GameState.towerVersion it was baked for
+    int affordable;         // Affordable tower options bitmask it was baked for
+} StaticLayer;
+
 // Graphics and Font Resources
 typedef struct {
     SDL_Texture *mapTexture;
     SDL_Texture *mainMenuBg;
-    SDL_Texture *shadow;
     TTF_Font *font;
-    SDL_Texture *enemyTextures[3]; // 0=red, 1=blue, 2=yellow
-    SDL_Texture *projectileTextures[2]; // 0=dart, 1=bullet
-    SDL_Texture *towerBaseTextures[3]; // 0=super, 1=bat, 2=brown
-    SDL_Texture *towerAttackTextures[3]; // 0=super, 1=bat, 2=brown
-    SDL_Texture *towerIconTextures[3]; // 0=super, 1=bat, 2=brown
+    // Gameplay sprites, all packed into the atlas pages below
+    Sprite shadow;
+    Sprite enemySprites[3]; // 0=red, 1=blue, 2=yellow
+    Sprite projectileSprites[2]; // 0=dart, 1=bullet
+    Sprite towerBaseSprites[3]; // 0=super, 1=bat, 2=brown
+    Sprite towerAttackSprites[3]; // 0=super, 1=bat, 2=brown
+    Sprite towerIconSprites[3]; // 0=super, 1=bat, 2=brown
+    SDL_Texture *atlasPages[ATLAS_MAX_PAGES];
+    int numAtlasPages;
     TowerOption towerOptions[3];
+    Paths *paths;             // Lane geometry, never written after loading
+    SpriteBatch *spriteBatch; // Map sprites, one draw call per texture and layer
+    TextCache *textCache;     // Rendered HUD strings for font
+    StaticLayer staticLayer;
+    AssetPack *pack;          // Mapped asset archive, NULL when loading loose files
 } GameResources;
 
 // Main Game State Container
 typedef struct {
     Enemy enemies[MAX_ENEMIES];             int numEnemiesActive;
     Bird placedBirds[MAX_PLACED_BIRDS];     int numPlacedBirds;
+    Uint32 towerVersion;                    // Bumped when towers change (invalidates the static render layer)
+    Uint32 nextEntityId;                    // Last id given to an enemy or projectile (0 = none)
     Projectile projectiles[MAX_PROJECTILES]; int numProjectiles;
 
     // Game Status & Player Info
-    MoneyManager team_money[NUM_TEAMS];
+    MoneyManagerData team_money[NUM_TEAMS]; // Inline, use &team_money[t] with money_manager_*
     int leftPlayerHP;
     int rightPlayerHP;
     bool gameOver;
@@ -125,15 +162,39 @@ typedef struct {
     float spawnTimer;
     int enemySpawnCounter;
 
-    // Path Data
-    Paths *paths;
-
     // UI State
     bool placingBird;
     int selectedOption;
 
 } GameState;
 
+// What the render thread draws for a frame
+typedef enum {
+    RENDER_VIEW_MENU,
+    RENDER_VIEW_STATUS,     // Status text only (connecting)
+    RENDER_VIEW_GAME,
+    RENDER_VIEW_GAME_OVER,
+    RENDER_VIEW_ERROR
+} RenderView;
+
+// Immutable per-frame snapshot the logic thread hands to the render thread
+// (see renderqueue.h). Everything the frame needs is copied in.
+typedef struct {
+    RenderView view;
+    bool quit;                              // Logic thread is done, render loop exits
+    GameState state;
+    float birdRotations[MAX_PLACED_BIRDS];
+    bool placingBird;
+    int selectedOption;
+    int playerIndex;                        // -1 in singleplayer
+    char statusText[256];
+    char overlayText[128];                  // Game over message
+    bool canRematch;                        // Game over: SPACE starts a new match
+    char netStatsLine[200];                 // Empty when the stats line is off
+    InterpFrame previous;                   // Singleplayer: transforms before the latest step
+    Uint64 stepCounter;                     // Singleplayer: performance counter of the latest step, 0 = no interpolation
+} RenderFrame;
+
 
 // Client-Specific State
 typedef enum {
@@ -152,8 +213,8 @@ typedef struct ClientInstance {
     SDL_Window* window;
     SDL_Renderer* renderer;
     bool is_running;
-    GameResources resources;
-    Audio audio;
+    GameResources* resources; // Borrowed from the AppContext
+    Audio* audio;
     GameState localGameState;
     ClientState state;
     char statusText[256];
@@ -164,10 +225,23 @@ typedef struct ClientInstance {
     int playerIndex;
     UDPsocket socket;
     IPaddress serverAddress;
+    bool useLocalLink;       // Host mode: in-process link instead of UDP
     UDPpacket* packet_in;
     UDPpacket* packet_out;
+    Reassembler* reassembler; // Rebuilds fragmented snapshots
+    NetConditioner* condIn;  // EGG_NETCOND impairment, NULL when off
+    NetConditioner* condOut;
+    bool spectator;          // Read-only viewer, no player slot
+    SpectatorView* spectatorView;
+    Uint32 lastSpectateSendTime;
     Uint32 lastReadySendTime;
     Uint32 lastHeartbeatSendTime;
+    NetStats netStats;       // RTT, jitter, loss and bandwidth to the server
+    Uint32 hashMismatches;   // Snapshots whose checksum did not match after decoding
+    bool showNetStats;       // F3: stats line in the HUD
+    FILE* statsCsv;          // F5: CSV export, NULL when off
+    Uint32 lastStatsCsvTime;
+    struct RenderQueue* renderQueue; // Frames to the render (main) thread, input back
 } ClientInstance;
 
 
@@ -176,34 +250,79 @@ typedef struct {
     IPaddress address;
     bool ready;
     Uint32 lastPacketTime;
+    bool timedOut;           // Silent for SERVER_CLIENT_TIMEOUT, no snapshots until it speaks again
+    NetStats stats;
 } ClientInfo;
 
+// Read-only viewer (a spectating client or a relay)
+typedef struct {
+    IPaddress address;
+    Uint32 lastPacketTime;
+    NetStats stats;
+} SpectatorInfo;
+
 typedef struct ServerInstance {
     SDL_Window* debugWindow;
     SDL_Renderer* debugRenderer;
     bool is_running;
-    GameResources resources;
+    bool hosted;             // Thread in the host's process: no window, no SDL init/quit, no event polling
+    GameResources resources; // Hosted: gameplay-only copy of the app's resources
     Audio audio; 
-    GameState gameState;
+    Arena* matchArena;       // Everything that lives for one match, released at once
+    GameState* gameState;    // In matchArena
+    GameStateSnapshot* snapshotScratch; // In matchArena, remote clients' snapshot
     float birdRotations[MAX_PLACED_BIRDS];
-    UDPsocket socket;
+    Transport* transport;
     UDPpacket* packet_in;
-    UDPpacket* packet_out;
     int num_clients;
     ClientInfo clients[MAX_PLAYERS];
+    SpectatorInfo spectators[MAX_SPECTATORS];
+    int num_spectators;
+    SpectatorFeed* spectatorFeed; // Delta-compressed reduced-rate stream
+    TickLoop* tickLoop;      // Wakes on socket data or tick deadlines
+    Uint32 tickCount;
+    Uint32 matchTick;        // Simulation ticks since the match started
+    Uint32 stateHash;        // state_hash after the latest tick
+    struct SaveStateWriter* checkpointWriter; // EGG_CHECKPOINT, NULL when off
+    const char* checkpointPath;
+    const char* resumePath;  // EGG_LOAD_STATE: the first match starts from this save state
+    struct ReplayRecorder* replay; // EGG_REPLAY, the running match's recording
+    const char* replayPath;
+    int matchesStarted;
     Uint32 lastTickTime;
+    Uint16 nextMessageId;    // Id for the next fragmented message
+    FILE* statsCsv;          // F5: per-client CSV export, NULL when off
+    Uint32 lastStatsCsvTime;
 } ServerInstance;
 
 
+// Window, renderer and loaded resources for the whole run of the program.
+// Created once by main; the mode menu and every mode borrow them, so going
+// back to the menu, switching mode or starting a new game reloads nothing.
+typedef struct {
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    GameResources resources;
+    Audio audio;
+    bool quit;              // Window closed inside a mode: leave instead of showing the menu again
+} AppContext;
+
+// Called on the loading thread each time one more asset file is decoded
+typedef void (*LoadProgressFn)(SDL_Renderer *renderer, GameResources *resources, int done, int total);
+
 // Function Declarations
 // engine.c: Core SDL, Resource, Audio, Time Management
 bool initialize_sdl(SDL_Window **window, SDL_Renderer **renderer, const char* title);
 bool initialize_subsystems();
-bool initialize_audio(Audio *audio);
 bool load_resources(SDL_Renderer *renderer, GameResources *resources, Audio *audio);
+bool load_resources_with_progress(SDL_Renderer *renderer, GameResources *resources, Audio *audio, LoadProgressFn progress); // progress may be NULL
+bool load_gameplay_data(GameResources *resources); // Paths and tower stats only, for headless tools (free paths with destroyPaths)
 void cleanup_resources(GameResources *resources, Audio *audio);
 void cleanup_sdl(SDL_Window *window, SDL_Renderer *renderer);
 void cleanup_subsystems();
+bool app_init(AppContext *app, const char *title); // SDL, subsystems, window and resources, once per process
+void app_shutdown(AppContext *app);
+void share_gameplay_resources(GameResources *dst, const GameResources *src); // Copy without textures/font, for the host's server thread
 SDL_Texture* load_texture(SDL_Renderer *renderer, const char *path);
 void play_sound(const Audio *audio, Mix_Chunk* sound);
 void play_music(Mix_Music* music);
@@ -212,12 +331,16 @@ float get_delta_time(Uint32 *last_time);
 float distance_between_points(float x1, float y1, float x2, float y2);
 
 // gameState.c: Initialization and placement logic
+extern bool gameplayLog; // Per-event prints (placements, game over), batch tools turn it off
 void initialize_game_state(GameState *gameState, GameResources *resources);
+void game_state_reset(GameState *gameState, GameResources *resources); // New match in place
 bool place_tower(GameState *gameState, GameResources *resources, int towerTypeIndex, int x, int y, int ownerPlayerIndex);
+void game_state_step(GameState *gameState, GameResources *resources, const Audio *audio, float dt); // One server tick, also replays
 
 // enemy.c: Enemy logic
-void update_enemies(GameState *gameState, float dt);
+void update_enemies(GameState *gameState, const GameResources *resources, float dt);
 void spawn_enemy_pair(GameState *gameState, GameResources *resources);
+int enemy_sprite_for_hp(int hp); // enemySprites index of a damaged enemy
 
 // birds.c: Tower logic
 void update_towers(GameState *gameState, const Audio *audio, float dt, GameResources *resources); 
@@ -226,6 +349,14 @@ void calculate_tower_rotations(GameState *gameState, float birdRotations[]);
 // projectiles.c: Projectile logic
 void update_projectiles(GameState *gameState, float dt);
 
+// interp.c: Render interpolation between fixed simulation steps
+void interp_capture(InterpFrame *frame, const GameState *gameState); // Call before each step
+void interp_apply(const InterpFrame *prev, GameState *renderState, float alpha); // renderState = copy of the current state
+
+// statehash.c: Checksum of the simulation state, for desync and determinism checks
+Uint32 state_hash(const GameState *gameState); // Never 0
+bool state_hash_diff(const GameState *a, const GameState *b, char *out, size_t cap); // true if they differ, out names the first field
+
 // money.c: Money logic
 void handle_money_gain(GameState *gameState, float dt);
 
@@ -233,21 +364,25 @@ void handle_money_gain(GameState *gameState, float dt);
 void render_main_menu(SDL_Renderer *renderer, GameResources *resources, BuildMode mode); // Takes BuildMode
 void render_game(SDL_Renderer *renderer, GameState *gameState, GameResources *resources, float birdRotations[], bool placingBird, int selectedOption, int localPlayerIndex);
 void render_placement_preview(SDL_Renderer *renderer, GameResources *resources, int selectedOption, int mouseX, int mouseY);
-void render_game_over(SDL_Renderer* renderer, GameResources* resources, const char* message);
-void render_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, SDL_Color color, bool center);
+void render_game_over(SDL_Renderer* renderer, GameResources* resources, const char* message, bool canRematch);
+void render_loading_screen(SDL_Renderer *renderer, GameResources *resources, int done, int total); // LoadProgressFn, presents
+void render_invalidate_static_layer(GameResources *resources); // Forces a rebake after lost render targets, render thread only
+void render_frame(SDL_Renderer *renderer, GameResources *resources, RenderFrame *frame, BuildMode mode); // Draws and presents one frame from the render queue
 
 // input.c: Input handling
 typedef enum { INPUT_CONTEXT_MAIN_MENU, INPUT_CONTEXT_SINGLEPLAYER, INPUT_CONTEXT_CLIENT } InputContext;
-void handle_input(InputContext context, GameState *gameState, GameResources *resources, ClientInstance *client, bool *quit_flag_ptr);
+void handle_input(InputContext context, GameState *gameState, GameResources *resources, ClientInstance *client, const SDL_Event *event, bool *quit_flag_ptr); // One event, on the logic thread
 
 // client.c: Client network handling and main loop
-int run_client(const char* server_ip_str);
+int run_client(AppContext *app, const char* server_ip_str); // NULL ip: the server thread of this process
+int run_spectator(AppContext *app, const char* server_ip_str); // Server or relay, "host" or "host:port"
 void send_client_packet(ClientInstance* client, ClientPacketData* data); // Used by input.c
 
 // server.c: Server network handling and main loop
-int run_server(void);
+int run_server(const GameResources *shared); // shared != NULL: headless host mode thread using the app's gameplay data
+void stop_server(void); // Host mode: makes run_server return
 // Internal server/client helpers like apply_snapshot, prepare_snapshot, etc. are static and not declared here
 
-void run_singleplayer(void); 
+void run_singleplayer(AppContext *app);
 
 #endif // ENGINE_H
\ No newline at end of file
@@ -0,0 +1,45 @@
+// fragment.h
+#ifndef FRAGMENT_H
+#define FRAGMENT_H
+
+#include <stdbool.h>
+#include <SDL2/SDL_net.h>
+#include "defs.h"
+#include "network.h"
+#include "transport.h"
+
+// Bytes of message data carried by one fragment
+#define FRAGMENT_PAYLOAD_SIZE ((int)(NET_MTU_PAYLOAD - sizeof(FragmentHeader)))
+// Largest message that can be fragmented
+#define FRAGMENT_MAX_MESSAGE_SIZE (FRAGMENT_PAYLOAD_SIZE * FRAGMENT_MAX_COUNT)
+
+/**
+ * @brief Splits a message into MTU-sized SERVER_CMD_FRAGMENT datagrams and
+ * queues them on the transport. Small messages become a single fragment.
+ * @return Number of fragments queued, or 0 if the message is too large.
+ */
+int fragment_send(Transport *t, IPaddress address, uint16_t messageId, const void *data, int len);
+
+// Opaque type for client-side reassembly of fragmented messages
+typedef struct Reassembler Reassembler;
+
+Reassembler *reassembler_create(void);
+void reassembler_destroy(Reassembler *r);
+
+/**
+ * @brief Feeds one SERVER_CMD_FRAGMENT datagram into the reassembler.
+ * @param outLen Set to the message length when a message completes.
+ * @return Pointer to the complete message (valid until the next call), or NULL.
+ */
+const Uint8 *reassembler_accept(Reassembler *r, const Uint8 *data, int len, Uint32 now, int *outLen);
+
+/**
+ * @brief Expires messages whose fragments have been missing for longer than
+ * FRAGMENT_TIMEOUT_MS. If the leading fragments of an expired message arrived,
+ * that prefix is returned so the receiver can still use it.
+ * @param outLen Set to the prefix length when one is returned.
+ * @return Pointer to the partial message (valid until the next call), or NULL.
+ */
+const Uint8 *reassembler_expire(Reassembler *r, Uint32 now, int *outLen);
+
+#endif // FRAGMENT_H
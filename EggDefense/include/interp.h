@@ -0,0 +1,25 @@
+// interp.h
+#ifndef INTERP_H
+#define INTERP_H
+
+#include <SDL2/SDL.h>
+#include "defs.h"
+
+// Render interpolation between two fixed-rate simulation steps. The frame
+// holds the transforms of moving entities from the previous step, matched by
+// entity id (the entity arrays are compacted by swapping, so indices move).
+typedef struct {
+    Uint32 id;
+    float x, y, angle;
+} InterpEntity;
+
+typedef struct {
+    InterpEntity enemies[MAX_ENEMIES];
+    int numEnemies;
+    InterpEntity projectiles[MAX_PROJECTILES];
+    int numProjectiles;
+} InterpFrame;
+
+// Functions are declared in engine.h (they take GameState)
+
+#endif // INTERP_H
@@ -0,0 +1,39 @@
+// locallink.h
+#ifndef LOCALLINK_H
+#define LOCALLINK_H
+
+#include <stdbool.h>
+#include <SDL2/SDL_net.h>
+#include "defs.h"
+#include "network.h"
+
+// In-process link between the server thread and the host's own client.
+// Commands travel through lock-free single-producer/single-consumer rings and
+// snapshots through a triple buffer, so the host player skips serialization,
+// loopback UDP and the syscalls that come with it. Remote clients keep UDP.
+
+// The server sees the local client at this address (port 0 never arrives over UDP)
+#define LOCAL_LINK_HOST 0
+#define LOCAL_LINK_PORT 0
+
+void locallink_open(void);
+void locallink_close(void);
+bool locallink_is_open(void);
+bool locallink_is_local_address(IPaddress address);
+
+// Client -> server commands
+bool locallink_client_send(const void *data, int len);
+int locallink_server_recv(UDPpacket *packet); // 1 if a command was copied into packet, else 0
+
+// Server -> client small messages (everything but snapshots)
+bool locallink_server_send(const void *data, int len);
+int locallink_client_recv(Uint8 *buf, int cap); // Message length, 0 if none
+
+// Server -> client snapshots. The server fills the buffer returned by
+// locallink_snapshot_begin and hands it over with locallink_snapshot_publish.
+GameStateSnapshot *locallink_snapshot_begin(void);
+void locallink_snapshot_publish(ServerCommandType command);
+// Latest unseen snapshot (owned by the link until the next call), or NULL
+const GameStateSnapshot *locallink_snapshot_take(ServerCommandType *command);
+
+#endif // LOCALLINK_H
@@ -4,26 +4,19 @@
 #include <stdbool.h>
 #include "defs.h" // För START_MONEY, MONEY_INTERVAL, MONEY_GAIN
 
-// ----- Datastruktur (Opaque Pointer för bättre inkapsling) -----
-// Vi deklarerar bara att typen finns här. Definitionen finns i .c-filen.
+// ----- Datastruktur -----
+// Definitionen finns här (inte i .c-filen) så att saldot kan ligga direkt i
+// GameState utan heap-pekare. Fälten ändras bara via funktionerna nedan.
+typedef struct MoneyManagerData {
+    int current_money;
+    float money_timer;
+} MoneyManagerData;
 typedef struct MoneyManagerData* MoneyManager;
 
 // ----- Funktionsdeklarationer (Gränssnitt) -----
 
-/**
- * @brief Skapar och initialiserar en ny pengahanterare.
- * @return En pekare till den nya MoneyManager-instansen, eller NULL vid fel.
- */
-MoneyManager money_manager_create();
-
 void money_manager_set_balance(MoneyManager mm, int amount);
 
-/**
- * @brief Frigör minnet som används av pengahanteraren.
- * @param mm Pekare till pengahanteraren som ska förstöras.
- */
-void money_manager_destroy(MoneyManager mm);
-
 /**
  * @brief Uppdaterar pengahanteraren baserat på förfluten tid (dt).
  * Hanterar den periodiska pengaökningen.
@@ -37,7 +30,7 @@ void money_manager_update(MoneyManager mm, float dt);
  * @param mm Pekare till pengahanteraren.
  * @return Den nuvarande pengasumman.
  */
-int money_manager_get_balance(const MoneyManager mm);
+int money_manager_get_balance(const MoneyManagerData *mm);
 
 /**
  * @brief Försöker spendera en viss summa pengar.
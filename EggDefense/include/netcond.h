@@ -0,0 +1,54 @@
+// netcond.h
+#ifndef NETCOND_H
+#define NETCOND_H
+
+#include <stdbool.h>
+#include <SDL2/SDL_net.h>
+#include "defs.h"
+
+// Network conditioner: delays, drops, duplicates and reorders datagrams so a
+// WAN can be emulated over loopback. One instance handles one direction.
+// Datagrams are pushed when they would have been sent/received and popped
+// once their delivery time has come.
+
+typedef struct {
+    Uint32 delayMs;         // Fixed one-way delay
+    Uint32 jitterMs;        // Random extra delay, 0..jitterMs
+    float lossPercent;      // Chance a datagram is dropped
+    float duplicatePercent; // Chance a datagram is delivered twice
+    float reorderPercent;   // Chance a datagram is held back so later ones overtake it
+    Uint32 seed;            // Same seed + same traffic = same impairments
+} NetConditionerConfig;
+
+/**
+ * @brief Reads the config from the EGG_NETCOND environment variable, e.g.
+ * "delay=80,jitter=20,loss=2,dup=0.5,reorder=5,seed=42".
+ * @return true if the variable is set and parsed.
+ */
+bool netcond_config_from_env(NetConditionerConfig *cfg);
+
+// Opaque type
+typedef struct NetConditioner NetConditioner;
+
+NetConditioner *netcond_create(const NetConditionerConfig *cfg);
+void netcond_destroy(NetConditioner *nc); // Prints what was done to the traffic
+
+/**
+ * @brief Creates one conditioner per direction from the same config, with
+ * separate random streams derived from the seed.
+ * @return false (and both NULL) on allocation failure.
+ */
+bool netcond_create_pair(const NetConditionerConfig *cfg, NetConditioner **out, NetConditioner **in);
+
+/**
+ * @brief Queues a datagram, applying loss/duplication/delay. The data is copied.
+ */
+void netcond_push(NetConditioner *nc, IPaddress address, const void *data, int len, Uint32 now);
+
+/**
+ * @brief Hands out the next datagram whose delivery time has passed.
+ * @return Pointer to the data (valid until the next call), or NULL if none is due.
+ */
+const Uint8 *netcond_pop(NetConditioner *nc, Uint32 now, IPaddress *address, int *len);
+
+#endif // NETCOND_H
@@ -0,0 +1,88 @@
+// netstats.h
+#ifndef NETSTATS_H
+#define NETSTATS_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <SDL2/SDL.h>
+#include "defs.h"
+#include "network.h"
+
+#define NETSTATS_SIZE_BUCKET_BYTES 256 // Width of one snapshot size histogram bucket
+#define NETSTATS_SIZE_BUCKETS 32       // Last bucket collects everything larger
+
+// Per-connection network statistics. Plain struct, embedded in ClientInfo
+// (server side) and ClientInstance (client side).
+typedef struct {
+    // Outgoing stamp state
+    Uint32 nextSequence;
+    Uint32 peerTimestamp;   // Latest timestamp the peer sent us
+    Uint32 peerTimestampAt; // Our clock when it arrived
+
+    // Round trip time from echoed timestamps (ms)
+    float rttMs;            // Smoothed RTT
+    float rttLastMs;        // Latest sample
+    bool hasRtt;
+    Uint32 lastEchoSeen;    // Echo already turned into a sample
+
+    // Jitter of one-way transit time, RFC 3550 style (ms)
+    float jitterMs;
+    bool hasTransit;
+    Sint64 lastTransit;
+
+    // Loss from sequence gaps
+    Uint32 highestSequence;
+    bool hasSequence;
+    Uint32 packetsExpected;
+    Uint32 packetsReceivedInOrder;
+    Uint32 packetsLate;     // Reordered: filled a gap that was counted as lost
+    Uint32 packetsDuplicate;// Sequence already seen, does not affect loss
+    Uint64 recentSeen;      // Bit i: highestSequence - i has arrived
+
+    // Totals and per-second rates
+    Uint64 bytesIn, bytesOut;
+    Uint64 packetsIn, packetsOut;
+    Uint64 windowBytesIn, windowBytesOut;
+    Uint64 windowPacketsIn, windowPacketsOut;
+    float bytesInPerSec, bytesOutPerSec;
+    float packetsInPerSec, packetsOutPerSec;
+    Uint32 windowStart;
+
+    // Snapshot size distribution (bytes)
+    Uint32 snapshotSizeBuckets[NETSTATS_SIZE_BUCKETS];
+    Uint32 snapshotCount;
+    Uint64 snapshotBytes;
+    int snapshotMin, snapshotMax;
+} NetStats;
+
+void netstats_reset(NetStats *s, Uint32 now);
+
+/**
+ * @brief Fills the stamp of an outgoing message: next sequence number, our
+ * clock, and the peer's latest timestamp echoed back with its hold time.
+ */
+void netstats_stamp(NetStats *s, PacketStamp *stamp, Uint32 now);
+
+/**
+ * @brief Feeds the stamp of an incoming message (loss, RTT and jitter).
+ */
+void netstats_on_stamp(NetStats *s, const PacketStamp *stamp, Uint32 now);
+
+void netstats_on_send(NetStats *s, int bytes, int packets);
+void netstats_on_receive(NetStats *s, int bytes); // Once per datagram
+void netstats_on_snapshot(NetStats *s, int bytes);
+
+// Rolls the per-second rates once a second has passed
+void netstats_update(NetStats *s, Uint32 now);
+
+float netstats_loss_percent(const NetStats *s);
+int netstats_snapshot_percentile(const NetStats *s, float fraction); // Upper bound of the bucket
+
+// One-line summary for the HUD / debug view
+void netstats_format(const NetStats *s, char *buf, size_t cap);
+
+// CSV export, one row per connection
+void netstats_write_csv_header(FILE *f);
+void netstats_write_csv_row(FILE *f, Uint32 now, const char *connection, const NetStats *s);
+
+#endif // NETSTATS_H
@@ -3,13 +3,24 @@
 
 #include "defs.h" // Includes MAX limits etc.
 #include <stdbool.h> // For bool type
+#include <stddef.h> // For offsetof
+#include <stdint.h>
+
+// Carried by every message in both directions (see netstats.h)
+typedef struct {
+    uint32_t sequence;      // Per-connection send counter, 0 = unstamped
+    uint32_t timestamp;     // Sender's SDL_GetTicks() when sent
+    uint32_t echoTimestamp; // Latest timestamp received from the peer
+    uint32_t echoDelay;     // ms the sender held echoTimestamp before this send
+} PacketStamp;
 
 // --- Client -> Server Commands ---
 typedef enum {
     CLIENT_CMD_NONE = 0,
     CLIENT_CMD_READY,         // Client is ready to join/start
     CLIENT_CMD_PLACE_TOWER,   // Client requests to place a tower
-    CLIENT_CMD_HEARTBEAT      // Client is still connected
+    CLIENT_CMD_HEARTBEAT,     // Client is still connected
+    CLIENT_CMD_SPECTATE       // Read-only viewer joining/keeping alive (no player slot)
 } ClientCommandType;
 
 // Client -> Server Packet Structure
@@ -19,6 +30,7 @@ typedef struct {
     int towerTypeIndex;     // Index of tower type to place (for PLACE_TOWER)
     int targetX;            // X coordinate for placement (for PLACE_TOWER)
     int targetY;            // Y coordinate for placement (for PLACE_TOWER)
+    PacketStamp stamp;      // Sequence and timestamps for RTT/loss statistics
 } ClientPacketData;
 
 
@@ -32,7 +44,9 @@ typedef enum {
     SERVER_CMD_GAME_OVER,           // Server signals the game has ended
     SERVER_CMD_REJECT_FULL,         // Server rejects connection because it's full
     SERVER_CMD_PLACE_TOWER_CONFIRM, // Server confirms successful tower placement
-    SERVER_CMD_PLACE_TOWER_REJECT   // Server rejects tower placement (e.g., no money, bad spot)
+    SERVER_CMD_PLACE_TOWER_REJECT,  // Server rejects tower placement (e.g., no money, bad spot)
+    SERVER_CMD_FRAGMENT,            // One MTU-sized piece of a larger message (see fragment.h)
+    SERVER_CMD_SPECTATOR_FRAME      // Reduced-rate spectator stream frame (see spectate.h)
 } ServerCommandType;
 
 
@@ -74,6 +88,7 @@ typedef struct {
     int currentWave;        // Aktuell våg 
     bool gameOver;          // True if the game has ended
     int winner;             // Player index of the winner (0 or 1 in 2-player, relevant for MP), or -1 if draw/SP loss
+    uint32_t stateHash;     // snapshot_hash as computed by the sender, 0 = not sent or cut short
 } GameStateSnapshot;
 
 
@@ -82,7 +97,28 @@ typedef struct {
     ServerCommandType command;
     int assignedPlayerIndex; // Sent with ASSIGN_INDEX
     int clientsConnected;    // Sent with WAITING
+    PacketStamp stamp;       // Sequence and timestamps for RTT/loss statistics
     GameStateSnapshot snapshot; // Sent with STATE_UPDATE and GAME_OVER
 } ServerPacketData;
 
+// Commands without a snapshot only send the fields before it
+#define SERVER_PACKET_HEADER_SIZE offsetof(ServerPacketData, snapshot)
+
+// Header in front of every SERVER_CMD_FRAGMENT datagram
+typedef struct {
+    ServerCommandType command;  // Always SERVER_CMD_FRAGMENT
+    uint16_t messageId;         // Same for all fragments of one message
+    uint8_t fragmentIndex;      // 0..fragmentCount-1
+    uint8_t fragmentCount;      // Total fragments in the message
+    uint16_t payloadSize;       // Bytes following this header
+} FragmentHeader;
+
+// Header in front of every spectator frame payload
+typedef struct {
+    uint16_t frameId;       // Increments with every frame
+    uint16_t keyframeId;    // Keyframe a delta applies to (== frameId for keyframes)
+    uint32_t payloadSize;   // Bytes following this header
+    uint32_t snapshotSize;  // Encoded snapshot size once the payload is applied
+} SpectatorFrameHeader;
+
 #endif // NETWORK_H
\ No newline at end of file
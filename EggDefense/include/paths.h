@@ -8,10 +8,19 @@
 // Opaque type for path data
 typedef struct Paths Paths;
 
+// A stretch of a path in path progress: segment index + fraction along it,
+// the same measure enemies use (currentSegment + segmentProgress)
+typedef struct {
+    float from, to;
+} PathInterval;
+
 Paths *createPaths(void);
 void destroyPaths(Paths *paths);
 int getNumPointsPaths(const Paths *paths);
 SDL_Point leftPointPaths(const Paths *paths, int index);
 SDL_Point rightPointPaths(const Paths *paths, int index);
+// The parts of a path (side 0 = left) inside a circle, in increasing order.
+// Returns how many were written to out, or -1 if there are more than maxOut.
+int circleCoveragePaths(const Paths *paths, int side, float cx, float cy, float radius, PathInterval *out, int maxOut);
 
 #endif // PATHS_H
\ No newline at end of file
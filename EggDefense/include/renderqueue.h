@@ -0,0 +1,43 @@
+// renderqueue.h
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include "engine.h"
+
+// Hand-over between the logic thread (network or simulation) and the render
+// thread. Frames travel through a triple buffer, so the logic thread never
+// waits for a vsync-blocked present and the render thread always draws the
+// newest complete frame. Input events travel the other way through a
+// single-producer/single-consumer ring.
+typedef struct RenderQueue RenderQueue;
+
+/**
+ * @brief Creates a queue with three frames and an empty input ring.
+ * @return The queue, or NULL on failure.
+ */
+RenderQueue *render_queue_create(void);
+void render_queue_destroy(RenderQueue *q);
+
+// Logic thread: fill the frame returned by render_queue_begin, then hand it
+// over with render_queue_publish
+RenderFrame *render_queue_begin(RenderQueue *q);
+void render_queue_publish(RenderQueue *q);
+
+// Render thread: newest published frame, owned by the render thread until the
+// next call. The same frame is returned again until a newer one is published.
+// NULL before the first publish.
+RenderFrame *render_queue_acquire(RenderQueue *q);
+
+// Render thread -> logic thread input. Push fails when the ring is full.
+bool render_queue_push_input(RenderQueue *q, const SDL_Event *event);
+bool render_queue_pop_input(RenderQueue *q, SDL_Event *event);
+
+// Render thread: polls SDL (window events must be pumped on the thread that
+// created the window), handles lost render targets and forwards quit, key and
+// mouse button events to the logic thread. Returns true if the window was
+// closed (the SDL_QUIT is forwarded as well).
+bool render_queue_pump_events(RenderQueue *q, GameResources *resources);
+
+#endif // RENDERQUEUE_H
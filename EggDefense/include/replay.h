@@ -0,0 +1,120 @@
+// replay.h
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include "engine.h"
+#include "savestate.h"
+
+// Seekable match replays. The file is a stream of chunks: every
+// REPLAY_KEYFRAME_INTERVAL ticks a keyframe (the full state, in save state
+// format) followed later by an event chunk with the commands up to the next
+// keyframe. Every tick is 1/tickRate long, the server never merges ticks.
+// Closing the recording appends an index of the keyframes and a trailer
+// pointing at it.
+//
+// Seeking restores the nearest keyframe at or before the tick and simulates
+// forward from there (game_state_step), at most one keyframe interval.
+// Chunks are written as the match runs, so a recording cut short by a crash
+// is still readable up to its last keyframe; the index is then rebuilt by
+// scanning.
+#define REPLAY_MAGIC 0x50524745u // "EGRP"
+#define REPLAY_VERSION 2 // 2: every step is 1/tickRate, no step events
+
+typedef enum {
+    REPLAY_CHUNK_KEYFRAME = 1,  // Save state of the match at tick
+    REPLAY_CHUNK_EVENTS   = 2,  // ReplayEvent records from tick to the next keyframe
+    REPLAY_CHUNK_INDEX    = 3   // ReplayIndexEntry per keyframe
+} ReplayChunkType;
+
+typedef enum {
+    REPLAY_EVENT_PLACE_TOWER = 1  // Accepted placement, applied before step tick -> tick + 1
+} ReplayEventType;
+
+typedef struct {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 tickRate;        // GAME_TICK_RATE of the recording server
+    Uint32 keyframeInterval;
+} ReplayFileHeader;
+
+typedef struct {
+    Uint32 type;            // ReplayChunkType
+    Uint32 tick;
+    Uint32 size;            // Bytes following this header
+} ReplayChunkHeader;
+
+typedef struct {
+    Uint32 tick;            // Ticks simulated when it happened
+    Uint8 type;             // ReplayEventType
+    Sint8 playerIndex;
+    Uint8 towerTypeIndex;
+    Uint8 reserved;
+    Sint16 x, y;
+} ReplayEvent;
+
+typedef struct {
+    Uint32 tick;
+    Uint32 offset;          // Keyframe chunk, from the start of the file
+} ReplayIndexEntry;
+
+typedef struct {
+    Uint32 indexOffset;     // Index chunk
+    Uint32 lastTick;
+    Uint32 magic;           // REPLAY_MAGIC, the file was closed properly
+} ReplayTrailer;
+
+// --- Recording (server) ---
+typedef struct ReplayRecorder ReplayRecorder;
+
+/**
+ * @brief Starts a recording with a keyframe of the match as it is now.
+ * @return The recorder, or NULL if the file cannot be written.
+ */
+ReplayRecorder *replay_recorder_open(const char *path, const GameState *gameState, Uint32 tick);
+
+/**
+ * @brief Writes what is still buffered, the index and the trailer.
+ */
+void replay_recorder_close(ReplayRecorder *rec);
+
+void replay_record_place_tower(ReplayRecorder *rec, Uint32 tick, int playerIndex, int towerTypeIndex, int x, int y);
+
+/**
+ * @brief Call after every simulated tick (always 1/tickRate long). tick is
+ * the count after the step, gameState the state after it (kept when a
+ * keyframe is due).
+ */
+void replay_record_step(ReplayRecorder *rec, Uint32 tick, const GameState *gameState);
+
+// --- Playback ---
+typedef struct Replay Replay;
+
+/**
+ * @brief Reads a replay into memory.
+ * @return The replay, or NULL if the file is missing or holds no keyframe.
+ */
+Replay *replay_open(const char *path);
+void replay_close(Replay *replay);
+
+Uint32 replay_first_tick(const Replay *replay);
+Uint32 replay_last_tick(const Replay *replay);
+int replay_num_keyframes(const Replay *replay);
+
+/**
+ * @brief State of the match after tick ticks (clamped to the recording):
+ * nearest keyframe, then simulated forward.
+ * @return false if the keyframe cannot be restored.
+ */
+bool replay_seek(const Replay *replay, Uint32 tick, GameState *out, GameResources *resources);
+
+/**
+ * @brief Simulates every keyframe interval and compares the result with the
+ * next keyframe: a replay-based determinism check.
+ * @param report Names the first differing field on a mismatch.
+ * @return true if every interval reproduced its keyframe.
+ */
+bool replay_verify(const Replay *replay, GameResources *resources, char *report, size_t cap);
+
+#endif // REPLAY_H
@@ -0,0 +1,67 @@
+// savestate.h
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <SDL2/SDL.h>
+#include "engine.h"
+
+// Save states: a complete match (entities, HP, money and money timers, wave
+// and spawn timers, tower cooldowns) in a small binary file. Only the used
+// entity slots are stored, a mid-game state is a few kB and loads with one
+// read and a few memcpy.
+//
+// Layout: SaveStateHeader, the GameState fields from team_money to the end
+// (tailSize bytes), then numEnemies Enemy, numBirds Bird and numProjectiles
+// Projectile records. Native byte order and struct layout, like the asset
+// pack; the record sizes in the header reject files from another build.
+#define SAVESTATE_MAGIC 0x56534745u // "EGSV"
+#define SAVESTATE_VERSION 3 // 2: Bird.damageDealt, 3: Bird.cover
+
+typedef struct {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 tick;            // Simulation ticks since the match started
+    Uint32 stateHash;       // state_hash of the saved state, checked on load
+    Uint32 nextEntityId;
+    Uint16 numEnemies, numBirds, numProjectiles;
+    Uint16 enemySize, birdSize, projectileSize; // sizeof of the records
+    Uint32 tailSize;
+} SaveStateHeader;
+
+// Largest possible save state
+#define SAVESTATE_MAX_SIZE (sizeof(SaveStateHeader) + sizeof(GameState))
+
+/**
+ * @brief Serializes a state into buf.
+ * @return Bytes written, or 0 if cap is too small.
+ */
+size_t savestate_encode(const GameState *gameState, Uint32 tick, Uint8 *buf, size_t cap);
+
+/**
+ * @brief Restores a state written by savestate_encode. gameState is only
+ * written when the data is valid and its checksum matches.
+ * @return false if the data is cut short, from another version or corrupt.
+ */
+bool savestate_decode(const Uint8 *buf, size_t len, GameState *gameState, Uint32 *tick);
+
+bool savestate_save(const char *path, const GameState *gameState, Uint32 tick);
+bool savestate_load(const char *path, GameState *gameState, Uint32 *tick);
+
+// Writes save states on a background thread. Submitting copies the state
+// (one memcpy, the state is pointer-free) and returns; encoding and file
+// I/O happen on the writer thread. A state submitted while the previous one
+// is still being written replaces any that is waiting, the newest wins.
+typedef struct SaveStateWriter SaveStateWriter;
+
+SaveStateWriter *savestate_writer_create(void);
+
+/**
+ * @brief Finishes the write in progress and any waiting one, then frees.
+ */
+void savestate_writer_destroy(SaveStateWriter *writer);
+
+bool savestate_writer_submit(SaveStateWriter *writer, const char *path, const GameState *gameState, Uint32 tick);
+
+#endif // SAVESTATE_H
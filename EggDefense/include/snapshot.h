@@ -0,0 +1,66 @@
+// snapshot.h
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "network.h"
+
+// Compact wire header for a GameStateSnapshot. Entity records follow it in
+// priority order: towers, enemies (furthest along the path first), projectiles.
+// A message cut short by a lost fragment therefore still holds the most
+// important entities.
+typedef struct {
+    int32_t money;
+    int32_t leftPlayerHP;
+    int32_t rightPlayerHP;
+    int32_t currentWave;
+    int32_t winner;
+    uint32_t stateHash;     // 0 when SNAPSHOT_STATE_HASH is off
+    uint8_t gameOver;
+    uint8_t numPlacedBirds;
+    uint16_t numEnemiesActive;
+    uint16_t numProjectiles;
+} SnapshotWireHeader;
+
+// Largest possible encoded snapshot
+#define SNAPSHOT_MAX_ENCODED_SIZE ((int)(sizeof(SnapshotWireHeader) + \
+    MAX_PLACED_BIRDS * sizeof(BirdSnapshotData) + \
+    MAX_ENEMIES * sizeof(EnemySnapshotData) + \
+    MAX_PROJECTILES * sizeof(ProjectileSnapshotData)))
+
+// FNV-1a, also used for the full-state checksum (see statehash.c)
+#define STATE_HASH_SEED 2166136261u
+
+static inline uint32_t hash_bytes(uint32_t hash, const void *data, size_t len) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; ++i) hash = (hash ^ p[i]) * 16777619u;
+    return hash;
+}
+
+/**
+ * @brief Checksum over what a snapshot carries on the wire: the header
+ * fields and the active entities, field by field in wire order. The sender
+ * stamps it into the header and the receiver recomputes it after decoding,
+ * so a mismatch means the two sides disagree about the state (bad delta,
+ * encode/decode bug, corrupt datagram).
+ * @return Never 0, that value means "no checksum".
+ */
+uint32_t snapshot_hash(const GameStateSnapshot *ss);
+
+/**
+ * @brief Writes the active entities of a snapshot in wire format.
+ * @return Bytes written, or 0 if cap is too small.
+ */
+int snapshot_encode(const GameStateSnapshot *ss, uint8_t *buf, int cap);
+
+/**
+ * @brief Reads a wire-format snapshot. Sections cut off by a truncated
+ * buffer decode as many whole records as are present, and stateHash is then
+ * 0 since the checksum no longer applies.
+ * @return false if not even the header is present.
+ */
+bool snapshot_decode(const uint8_t *buf, int len, GameStateSnapshot *ss);
+
+#endif // SNAPSHOT_H
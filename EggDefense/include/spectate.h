@@ -0,0 +1,57 @@
+// spectate.h
+#ifndef SPECTATE_H
+#define SPECTATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <SDL2/SDL.h>
+#include "defs.h"
+#include "network.h"
+#include "snapshot.h"
+
+// Spectator stream: reduced-rate frames carrying either a keyframe (a full
+// wire-format snapshot, see snapshot.h) or a delta against the latest
+// keyframe. Deltas never chain, so a lost frame only costs that frame, and a
+// lost keyframe is repaired by the next one.
+//
+// Frame layout: [SpectatorFrameHeader][payload]. Delta payloads are runs of
+// [uint16 skip][uint16 count][count bytes] that patch the keyframe bytes.
+
+// Largest frame the feed can produce
+#define SPECTATOR_MAX_FRAME_SIZE ((int)sizeof(SpectatorFrameHeader) + SNAPSHOT_MAX_ENCODED_SIZE)
+
+// Opaque type for the sending side (server)
+typedef struct SpectatorFeed SpectatorFeed;
+
+SpectatorFeed *spectator_feed_create(void);
+void spectator_feed_destroy(SpectatorFeed *feed);
+
+/**
+ * @brief Makes the next frame a keyframe (e.g. when a spectator joins).
+ */
+void spectator_feed_force_keyframe(SpectatorFeed *feed);
+
+/**
+ * @brief Encodes the next frame. Falls back to a keyframe whenever the delta
+ * would not be smaller.
+ * @param outLen Set to the frame length.
+ * @return Pointer to the frame (valid until the next call), or NULL on error.
+ */
+const Uint8 *spectator_feed_encode(SpectatorFeed *feed, const GameStateSnapshot *snapshot, int *outLen);
+
+// True if the frame carries a full snapshot (relays cache these for late joiners)
+bool spectator_frame_is_keyframe(const Uint8 *frame, int len);
+
+// Opaque type for the receiving side (spectating client)
+typedef struct SpectatorView SpectatorView;
+
+SpectatorView *spectator_view_create(void);
+void spectator_view_destroy(SpectatorView *view);
+
+/**
+ * @brief Decodes a frame into a snapshot.
+ * @return false for truncated frames and for deltas whose keyframe is missing.
+ */
+bool spectator_view_apply(SpectatorView *view, const Uint8 *frame, int len, GameStateSnapshot *out);
+
+#endif // SPECTATE_H
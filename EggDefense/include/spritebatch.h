@@ -0,0 +1,38 @@
+// spritebatch.h
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include "defs.h"
+
+// Collects rotated sprite quads into vertex arrays, grouped per texture, and
+// submits each group with one SDL_RenderGeometry call. Replaces one
+// SDL_RenderCopyEx per entity, so draw calls per layer stay constant no matter
+// how many enemies, birds or projectiles are on the map. Alpha is carried in
+// the vertex colour, so no SDL_SetTextureAlphaMod inside the loops.
+typedef struct SpriteBatch SpriteBatch;
+
+/**
+ * @brief Creates a batch drawing to the given renderer.
+ * @return The batch, or NULL on failure.
+ */
+SpriteBatch *spritebatch_create(SDL_Renderer *renderer);
+void spritebatch_destroy(SpriteBatch *batch);
+
+/**
+ * @brief Queues a sprite centred on (cx, cy), w x h pixels, rotated
+ * angleDeg degrees clockwise around its centre (same as SDL_RenderCopyEx).
+ * @param src Source rect in the texture, NULL for the whole texture.
+ */
+void spritebatch_add(SpriteBatch *batch, SDL_Texture *texture, const SDL_Rect *src,
+                     float cx, float cy, float w, float h, float angleDeg, Uint8 alpha);
+
+/**
+ * @brief Draws everything queued, one call per texture, and empties the batch.
+ * Call between layers to keep them in order.
+ * @return Number of draw calls issued.
+ */
+int spritebatch_flush(SpriteBatch *batch);
+
+#endif // SPRITEBATCH_H
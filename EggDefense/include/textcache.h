@@ -0,0 +1,36 @@
+// textcache.h
+#ifndef TEXTCACHE_H
+#define TEXTCACHE_H
+
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include "defs.h"
+
+// LRU cache of rendered strings for one renderer and font, keyed by
+// (text, colour). HUD text (money, wave, HP, prices) rarely changes, so after
+// the first frame drawing a string is a lookup and one SDL_RenderCopy, with no
+// TTF rendering or texture allocation.
+typedef struct TextCache TextCache;
+
+/**
+ * @brief Creates a cache of TEXT_CACHE_SIZE strings. Must be destroyed before
+ * the renderer and the font.
+ * @return The cache, or NULL on failure.
+ */
+TextCache *text_cache_create(SDL_Renderer *renderer, TTF_Font *font);
+void text_cache_destroy(TextCache *cache);
+
+/**
+ * @brief Size of the rendered string in pixels (renders and caches it if needed).
+ * @return false if the text could not be rendered.
+ */
+bool text_cache_measure(TextCache *cache, const char *text, SDL_Color color, int *w, int *h);
+
+/**
+ * @brief Draws text at (x, y), horizontally centred on x if center is set.
+ * Strings longer than TEXT_CACHE_MAX_TEXT are rendered uncached.
+ */
+void render_text(TextCache *cache, const char *text, int x, int y, SDL_Color color, bool center);
+
+#endif // TEXTCACHE_H
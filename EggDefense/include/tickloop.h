@@ -0,0 +1,44 @@
+// tickloop.h
+#ifndef TICKLOOP_H
+#define TICKLOOP_H
+
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include "defs.h"
+#include "transport.h"
+
+// Server main loop pacing. Sleeps until the transport socket is readable or
+// the next tick deadline passes, instead of polling and sleeping whole
+// milliseconds. Deadlines are absolute, so late wakeups do not push later
+// ticks back. On Linux this is epoll + timerfd; elsewhere an absolute-deadline
+// scheduler on the performance counter.
+typedef struct TickLoop TickLoop;
+
+/**
+ * @brief Creates a loop ticking at tickRate Hz, watching the transport's socket.
+ * @return The loop, or NULL on failure.
+ */
+TickLoop *tickloop_create(Transport *transport, int tickRate);
+void tickloop_destroy(TickLoop *loop);
+
+/**
+ * @brief Idle loops tick every SERVER_IDLE_TICK_MS instead of at the full
+ * rate (nothing to simulate, only the debug window and lobby messages).
+ * Going active restarts the tick schedule from now.
+ */
+void tickloop_set_idle(TickLoop *loop, bool idle);
+
+/**
+ * @brief Blocks until the socket is readable or a tick is due.
+ * @return Number of ticks due (more than 1 if the caller fell behind), or 0
+ * if only network data arrived.
+ */
+int tickloop_wait(TickLoop *loop);
+
+// Wakeup lateness against the tick deadline, microseconds (EWMA and max)
+float tickloop_lateness_avg_us(const TickLoop *loop);
+float tickloop_lateness_max_us(const TickLoop *loop);
+
+const char *tickloop_backend_name(const TickLoop *loop);
+
+#endif // TICKLOOP_H
@@ -0,0 +1,64 @@
+// transport.h
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <stdbool.h>
+#include <SDL2/SDL_net.h>
+#include "defs.h"
+#include "netcond.h"
+
+// Opaque type for the server UDP transport.
+// On Linux datagrams are drained with recvmmsg and queued sends are flushed
+// with a single sendmmsg. Other platforms fall back to SDL_net.
+typedef struct Transport Transport;
+
+/**
+ * @brief Opens a UDP transport bound to the given port (0 = any free port).
+ * @return The new transport, or NULL on failure.
+ */
+Transport *transport_open(Uint16 port);
+
+/**
+ * @brief Flushes pending sends and closes the socket.
+ */
+void transport_close(Transport *t);
+
+/**
+ * @brief Copies the next received datagram into packet (data, len, address).
+ * @return 1 if a datagram was delivered, 0 if none is waiting, -1 on error.
+ */
+int transport_recv(Transport *t, UDPpacket *packet);
+
+/**
+ * @brief Queues a datagram for sending. The data is copied, so the caller
+ * may reuse its buffer directly. Queued datagrams leave on transport_flush
+ * (or when the queue fills up).
+ * @return true if the datagram was queued/sent.
+ */
+bool transport_send(Transport *t, IPaddress address, const void *data, int len);
+
+/**
+ * @brief Sends every queued datagram.
+ * @return Number of datagrams handed to the OS.
+ */
+int transport_flush(Transport *t);
+
+/**
+ * @brief Routes sends and receives through network conditioners (one per
+ * direction) built from cfg. Delayed sends leave on a later transport_flush.
+ * @return false if the conditioners could not be created.
+ */
+bool transport_set_conditioner(Transport *t, const NetConditionerConfig *cfg);
+
+/**
+ * @brief Pollable socket descriptor for event loops, or -1 if the backend
+ * has none (SDL_net).
+ */
+int transport_fd(const Transport *t);
+
+/**
+ * @brief Name of the active backend, for logging ("mmsg" or "sdlnet").
+ */
+const char *transport_backend_name(const Transport *t);
+
+#endif // TRANSPORT_H
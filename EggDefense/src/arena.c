@@ -0,0 +1,69 @@
+// arena.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+// Intern representation
+struct Arena {
+    Uint8 *block;
+    size_t capacity;
+    size_t offset;          // Next free byte
+    size_t peak;
+    Uint32 allocations;
+    Uint32 failed;
+};
+
+Arena *arena_create(size_t capacity) {
+    Arena *arena = calloc(1, sizeof *arena);
+    if (!arena) return NULL;
+    // malloc alignment is enough for ARENA_ALIGN on the platforms we build for
+    arena->block = malloc(capacity);
+    if (!arena->block) {
+        printf("Arena: failed to reserve %lu bytes\n", (unsigned long)capacity);
+        free(arena);
+        return NULL;
+    }
+    arena->capacity = capacity;
+    return arena;
+}
+
+void arena_destroy(Arena *arena) {
+    if (!arena) return;
+    free(arena->block);
+    free(arena);
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    if (!arena) return NULL;
+    size_t start = (arena->offset + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (start > arena->capacity || size > arena->capacity - start) {
+        arena->failed++;
+        printf("Arena: out of memory (%lu bytes requested, %lu of %lu used)\n",
+               (unsigned long)size, (unsigned long)arena->offset, (unsigned long)arena->capacity);
+        return NULL;
+    }
+    arena->offset = start + size;
+    if (arena->offset > arena->peak) arena->peak = arena->offset;
+    arena->allocations++;
+    void *memory = arena->block + start;
+    memset(memory, 0, size);
+    return memory;
+}
+
+void arena_reset(Arena *arena) {
+    if (!arena) return;
+    arena->offset = 0;
+    arena->allocations = 0;
+}
+
+ArenaStats arena_stats(const Arena *arena) {
+    ArenaStats stats = {0};
+    if (!arena) return stats;
+    stats.capacity = arena->capacity;
+    stats.used = arena->offset;
+    stats.peak = arena->peak;
+    stats.allocations = arena->allocations;
+    stats.failed = arena->failed;
+    return stats;
+}
@@ -0,0 +1,161 @@
+// assetloader.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL2/SDL_image.h>
+#include "assetloader.h"
+
+#define ASSET_PATH_MAX 256
+
+typedef struct {
+    AssetKind kind;
+    char path[ASSET_PATH_MAX];
+    void *result;           // Written by the worker before done is set
+    SDL_atomic_t done;
+} AssetJob;
+
+// Intern representation
+struct AssetLoader {
+    AssetJob *jobs;         // Fixed once started
+    int numJobs;
+    int capacity;
+    bool started;
+    SDL_atomic_t nextJob;   // Next unclaimed job, workers claim with SDL_AtomicAdd
+    SDL_sem *finished;      // Posted once per finished job
+    int numWaited;          // Finished jobs the caller has waited for
+    SDL_Thread *workers[ASSET_LOADER_MAX_WORKERS];
+    int numWorkers;
+};
+
+AssetLoader *asset_loader_create(void) {
+    AssetLoader *loader = calloc(1, sizeof *loader);
+    if (!loader) return NULL;
+    loader->finished = SDL_CreateSemaphore(0);
+    if (!loader->finished) {
+        printf("Asset loader: failed to create semaphore: %s\n", SDL_GetError());
+        free(loader);
+        return NULL;
+    }
+    return loader;
+}
+
+int asset_loader_add(AssetLoader *loader, AssetKind kind, const char *path) {
+    if (!loader || !path || loader->started || strlen(path) >= ASSET_PATH_MAX) return -1;
+    if (loader->numJobs == loader->capacity) {
+        int capacity = loader->capacity ? loader->capacity * 2 : 32;
+        AssetJob *jobs = realloc(loader->jobs, (size_t)capacity * sizeof(AssetJob));
+        if (!jobs) return -1;
+        loader->jobs = jobs;
+        loader->capacity = capacity;
+    }
+    AssetJob *job = &loader->jobs[loader->numJobs];
+    memset(job, 0, sizeof *job);
+    job->kind = kind;
+    snprintf(job->path, sizeof job->path, "%s", path);
+    return loader->numJobs++;
+}
+
+// Runs on a worker (or the caller without workers). SDL errors are per thread.
+static void *decode(const AssetJob *job) {
+    switch (job->kind) {
+        case ASSET_IMAGE: {
+            SDL_Surface *loaded = IMG_Load(job->path);
+            if (!loaded) {
+                printf("Error loading image '%s': %s\n", job->path, IMG_GetError());
+                return NULL;
+            }
+            SDL_Surface *rgba = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+            SDL_FreeSurface(loaded);
+            if (!rgba) printf("Error converting image '%s': %s\n", job->path, SDL_GetError());
+            return rgba;
+        }
+        case ASSET_SOUND: {
+            Mix_Chunk *chunk = Mix_LoadWAV(job->path);
+            if (!chunk) printf("Warning: Failed to load SFX '%s': %s\n", job->path, Mix_GetError());
+            return chunk;
+        }
+        case ASSET_MUSIC: {
+            Mix_Music *music = Mix_LoadMUS(job->path);
+            if (!music) printf("Warning: Failed to load BGM '%s': %s\n", job->path, Mix_GetError());
+            return music;
+        }
+    }
+    return NULL;
+}
+
+// Claims and decodes one job, false when none are left
+static bool run_one(AssetLoader *loader) {
+    int index = SDL_AtomicAdd(&loader->nextJob, 1);
+    if (index >= loader->numJobs) return false;
+    AssetJob *job = &loader->jobs[index];
+    job->result = decode(job);
+    SDL_AtomicSet(&job->done, 1); // Full barrier, result is visible first
+    SDL_SemPost(loader->finished);
+    return true;
+}
+
+static int worker_main(void *data) {
+    AssetLoader *loader = data;
+    while (run_one(loader)) {
+    }
+    return 0;
+}
+
+void asset_loader_start(AssetLoader *loader, int numWorkers) {
+    if (!loader || loader->started) return;
+    loader->started = true;
+    if (numWorkers <= 0) numWorkers = SDL_GetCPUCount();
+    if (numWorkers > ASSET_LOADER_MAX_WORKERS) numWorkers = ASSET_LOADER_MAX_WORKERS;
+    if (numWorkers > loader->numJobs) numWorkers = loader->numJobs;
+    for (int i = 0; i < numWorkers; ++i) {
+        SDL_Thread *thread = SDL_CreateThread(worker_main, "AssetWorker", loader);
+        if (!thread) {
+            printf("Asset loader: failed to create worker: %s\n", SDL_GetError());
+            break;
+        }
+        loader->workers[loader->numWorkers++] = thread;
+    }
+}
+
+int asset_loader_wait_next(AssetLoader *loader) {
+    if (!loader || !loader->started) return 0;
+    if (loader->numWaited >= loader->numJobs) return loader->numJobs;
+    if (loader->numWorkers == 0) run_one(loader); // No threads, decode here
+    SDL_SemWait(loader->finished);
+    return ++loader->numWaited;
+}
+
+int asset_loader_count(const AssetLoader *loader) {
+    return loader ? loader->numJobs : 0;
+}
+
+bool asset_loader_done(AssetLoader *loader, int job) {
+    if (!loader || job < 0 || job >= loader->numJobs) return false;
+    if (!SDL_AtomicGet(&loader->jobs[job].done)) return false;
+    SDL_MemoryBarrierAcquire();
+    return true;
+}
+
+void *asset_loader_take(AssetLoader *loader, int job) {
+    if (!asset_loader_done(loader, job)) return NULL;
+    void *result = loader->jobs[job].result;
+    loader->jobs[job].result = NULL;
+    return result;
+}
+
+void asset_loader_destroy(AssetLoader *loader) {
+    if (!loader) return;
+    // Jobs not claimed yet are skipped, workers finish the one they are on
+    SDL_AtomicSet(&loader->nextJob, loader->numJobs);
+    for (int i = 0; i < loader->numWorkers; ++i) SDL_WaitThread(loader->workers[i], NULL);
+    for (int i = 0; i < loader->numJobs; ++i) {
+        AssetJob *job = &loader->jobs[i];
+        if (!job->result) continue;
+        if (job->kind == ASSET_IMAGE) SDL_FreeSurface(job->result);
+        else if (job->kind == ASSET_SOUND) Mix_FreeChunk(job->result);
+        else Mix_FreeMusic(job->result);
+    }
+    SDL_DestroySemaphore(loader->finished);
+    free(loader->jobs);
+    free(loader);
+}
@@ -0,0 +1,129 @@
+// assetpack.c
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // mmap/madvise under -std=c11
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "assetpack.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Intern representation
+struct AssetPack {
+    Uint8 *data;            // Whole file
+    size_t size;
+    bool mapped;            // munmap instead of free
+    const AssetPackEntry *entries;
+    Uint32 numEntries;
+};
+
+// Whole file into memory: mapped where we can, one fread otherwise
+static bool map_file(AssetPack *pack, const char *path) {
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    // Private writable mapping: surfaces over it are not const, copy-on-write keeps the file safe
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    madvise(data, (size_t)st.st_size, MADV_WILLNEED); // Read ahead in one go
+    pack->data = data;
+    pack->size = (size_t)st.st_size;
+    pack->mapped = true;
+    return true;
+#else
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    pack->data = size > 0 ? malloc((size_t)size) : NULL;
+    bool ok = pack->data && fread(pack->data, 1, (size_t)size, f) == (size_t)size;
+    fclose(f);
+    if (!ok) {
+        free(pack->data);
+        pack->data = NULL;
+        return false;
+    }
+    pack->size = (size_t)size;
+    return true;
+#endif
+}
+
+AssetPack *asset_pack_open(const char *path) {
+    if (!path) return NULL;
+    AssetPack *pack = calloc(1, sizeof *pack);
+    if (!pack) return NULL;
+    if (!map_file(pack, path)) {
+        free(pack); // Missing pack is normal, the loose files are used then
+        return NULL;
+    }
+
+    const AssetPackHeader *header = (const AssetPackHeader *)pack->data;
+    bool valid = pack->size >= sizeof *header
+              && header->magic == ASSET_PACK_MAGIC
+              && header->version == ASSET_PACK_VERSION
+              && header->numEntries <= (pack->size - sizeof *header) / sizeof(AssetPackEntry);
+    if (valid) {
+        pack->entries = (const AssetPackEntry *)(pack->data + sizeof *header);
+        pack->numEntries = header->numEntries;
+        for (Uint32 i = 0; i < pack->numEntries && valid; ++i) {
+            const AssetPackEntry *e = &pack->entries[i];
+            valid = e->offset <= pack->size && e->size <= pack->size - e->offset
+                 && memchr(e->name, '\0', sizeof e->name) != NULL
+                 && (e->kind != ASSET_PACK_RGBA || (Uint64)e->width * e->height * 4 == e->size);
+        }
+    }
+    if (!valid) {
+        printf("Asset pack '%s' is invalid or from another version, ignoring it.\n", path);
+        asset_pack_close(pack);
+        return NULL;
+    }
+    printf("Asset pack '%s': %u files, %lu bytes.\n", path, (unsigned)pack->numEntries, (unsigned long)pack->size);
+    return pack;
+}
+
+void asset_pack_close(AssetPack *pack) {
+    if (!pack) return;
+#ifndef _WIN32
+    if (pack->mapped) munmap(pack->data, pack->size);
+    else free(pack->data);
+#else
+    free(pack->data);
+#endif
+    free(pack);
+}
+
+const AssetPackEntry *asset_pack_find(const AssetPack *pack, const char *name) {
+    if (!pack || !name) return NULL;
+    for (Uint32 i = 0; i < pack->numEntries; ++i) { // A few dozen entries, linear is fine
+        if (strcmp(pack->entries[i].name, name) == 0) return &pack->entries[i];
+    }
+    return NULL;
+}
+
+SDL_Surface *asset_pack_surface(const AssetPack *pack, const char *name) {
+    const AssetPackEntry *e = asset_pack_find(pack, name);
+    if (!e || e->kind != ASSET_PACK_RGBA) return NULL;
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(pack->data + e->offset, (int)e->width, (int)e->height,
+                                                              32, (int)e->width * 4, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) printf("Asset pack: surface for '%s' failed: %s\n", name, SDL_GetError());
+    return surface;
+}
+
+SDL_RWops *asset_pack_rw(const AssetPack *pack, const char *name) {
+    const AssetPackEntry *e = asset_pack_find(pack, name);
+    if (!e || e->kind != ASSET_PACK_RAW) return NULL;
+    return SDL_RWFromConstMem(pack->data + e->offset, (int)e->size);
+}
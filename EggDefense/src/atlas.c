@@ -0,0 +1,183 @@
+// atlas.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL2/SDL_image.h>
+#include "atlas.h"
+
+typedef struct {
+    SDL_Surface *surface;   // RGBA32, original size
+    Sprite *out;
+    int packedW, packedH;   // Size in the atlas (after downscaling)
+    int page;
+    int x, y;
+} AtlasEntry;
+
+// Intern representation
+struct AtlasBuilder {
+    AtlasEntry *entries;
+    int numEntries;
+    int capacity;
+};
+
+AtlasBuilder *atlas_builder_create(void) {
+    return calloc(1, sizeof(AtlasBuilder));
+}
+
+void atlas_builder_destroy(AtlasBuilder *builder) {
+    if (!builder) return;
+    for (int i = 0; i < builder->numEntries; ++i) SDL_FreeSurface(builder->entries[i].surface);
+    free(builder->entries);
+    free(builder);
+}
+
+bool atlas_builder_add(AtlasBuilder *builder, const char *path, Sprite *out) {
+    if (!builder || !path || !out) return false;
+    memset(out, 0, sizeof *out);
+
+    SDL_Surface *loaded = IMG_Load(path);
+    if (!loaded) {
+        printf("Error loading image '%s': %s\n", path, IMG_GetError());
+        return false;
+    }
+    SDL_Surface *rgba = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!rgba) {
+        printf("Error converting image '%s': %s\n", path, SDL_GetError());
+        return false;
+    }
+    return atlas_builder_add_surface(builder, rgba, out);
+}
+
+bool atlas_builder_add_surface(AtlasBuilder *builder, SDL_Surface *rgba, Sprite *out) {
+    if (!out) {
+        SDL_FreeSurface(rgba);
+        return false;
+    }
+    memset(out, 0, sizeof *out);
+    if (!builder || !rgba || rgba->format->format != SDL_PIXELFORMAT_RGBA32) {
+        SDL_FreeSurface(rgba);
+        return false;
+    }
+
+    if (builder->numEntries == builder->capacity) {
+        int capacity = builder->capacity ? builder->capacity * 2 : 16;
+        AtlasEntry *entries = realloc(builder->entries, (size_t)capacity * sizeof(AtlasEntry));
+        if (!entries) {
+            SDL_FreeSurface(rgba);
+            return false;
+        }
+        builder->entries = entries;
+        builder->capacity = capacity;
+    }
+
+    AtlasEntry *e = &builder->entries[builder->numEntries++];
+    memset(e, 0, sizeof *e);
+    e->surface = rgba;
+    e->out = out;
+    e->packedW = rgba->w;
+    e->packedH = rgba->h;
+    int longest = rgba->w > rgba->h ? rgba->w : rgba->h;
+    if (longest > ATLAS_MAX_SPRITE_SIZE) {
+        float scale = (float)ATLAS_MAX_SPRITE_SIZE / (float)longest;
+        e->packedW = (int)(rgba->w * scale + 0.5f);
+        e->packedH = (int)(rgba->h * scale + 0.5f);
+        if (e->packedW < 1) e->packedW = 1;
+        if (e->packedH < 1) e->packedH = 1;
+    }
+    out->w = rgba->w;
+    out->h = rgba->h;
+    return true;
+}
+
+static int compare_height_desc(const void *a, const void *b) {
+    const AtlasEntry *ea = *(const AtlasEntry *const *)a;
+    const AtlasEntry *eb = *(const AtlasEntry *const *)b;
+    if (ea->packedH != eb->packedH) return eb->packedH - ea->packedH;
+    return eb->packedW - ea->packedW;
+}
+
+// Shelf packing: fill rows left to right, start a new row (or page) when full
+static int pack(AtlasBuilder *builder, int pageHeights[], int maxPages) {
+    AtlasEntry **order = malloc((size_t)builder->numEntries * sizeof *order);
+    if (!order) return 0;
+    for (int i = 0; i < builder->numEntries; ++i) order[i] = &builder->entries[i];
+    qsort(order, (size_t)builder->numEntries, sizeof *order, compare_height_desc);
+
+    int page = 0, x = 0, y = 0, shelfH = 0;
+    pageHeights[0] = 0;
+    for (int i = 0; i < builder->numEntries; ++i) {
+        AtlasEntry *e = order[i];
+        int w = e->packedW + ATLAS_PADDING;
+        int h = e->packedH + ATLAS_PADDING;
+        if (x + w > ATLAS_PAGE_SIZE) { // Next shelf
+            y += shelfH;
+            x = 0;
+            shelfH = 0;
+        }
+        if (y + h > ATLAS_PAGE_SIZE) { // Next page
+            if (page + 1 >= maxPages) {
+                printf("Atlas: sprites do not fit in %d pages of %dx%d\n", maxPages, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+                free(order);
+                return 0;
+            }
+            page++;
+            pageHeights[page] = 0;
+            x = y = shelfH = 0;
+        }
+        e->page = page;
+        e->x = x;
+        e->y = y;
+        x += w;
+        if (h > shelfH) shelfH = h;
+        if (y + h > pageHeights[page]) pageHeights[page] = y + h;
+    }
+    free(order);
+    return page + 1;
+}
+
+int atlas_builder_build(AtlasBuilder *builder, SDL_Renderer *renderer, SDL_Texture **pages, int maxPages) {
+    if (!builder || !renderer || !pages || maxPages <= 0 || builder->numEntries == 0) return 0;
+
+    int pageHeights[ATLAS_MAX_PAGES];
+    if (maxPages > ATLAS_MAX_PAGES) maxPages = ATLAS_MAX_PAGES;
+    int numPages = pack(builder, pageHeights, maxPages);
+    if (numPages == 0) return 0;
+
+    for (int p = 0; p < numPages; ++p) {
+        // Zeroed, so the padding between sprites is transparent
+        SDL_Surface *page = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_PAGE_SIZE, pageHeights[p], 32, SDL_PIXELFORMAT_RGBA32);
+        if (!page) {
+            printf("Atlas: failed to create page surface: %s\n", SDL_GetError());
+            for (int q = 0; q < p; ++q) SDL_DestroyTexture(pages[q]);
+            return 0;
+        }
+        for (int i = 0; i < builder->numEntries; ++i) {
+            AtlasEntry *e = &builder->entries[i];
+            if (e->page != p) continue;
+            SDL_Rect dst = { e->x, e->y, e->packedW, e->packedH };
+            if (e->packedW == e->surface->w && e->packedH == e->surface->h) {
+                SDL_SetSurfaceBlendMode(e->surface, SDL_BLENDMODE_NONE); // Copy alpha as-is
+                SDL_BlitSurface(e->surface, NULL, page, &dst);
+            } else {
+                SDL_SoftStretchLinear(e->surface, NULL, page, &dst);
+            }
+        }
+        pages[p] = SDL_CreateTextureFromSurface(renderer, page);
+        SDL_FreeSurface(page);
+        if (!pages[p]) {
+            printf("Atlas: failed to create page texture: %s\n", SDL_GetError());
+            for (int q = 0; q < p; ++q) SDL_DestroyTexture(pages[q]);
+            return 0;
+        }
+        SDL_SetTextureBlendMode(pages[p], SDL_BLENDMODE_BLEND);
+    }
+
+    for (int i = 0; i < builder->numEntries; ++i) {
+        AtlasEntry *e = &builder->entries[i];
+        e->out->texture = pages[e->page];
+        e->out->src = (SDL_Rect){ e->x, e->y, e->packedW, e->packedH };
+    }
+    printf("Atlas: packed %d sprites into %d page(s).\n", builder->numEntries, numPages);
+    return numPages;
+}
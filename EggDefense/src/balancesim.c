@@ -0,0 +1,326 @@
+// balancesim.c
+// Headless balance runs: thousands of complete matches with scripted or
+// random build orders, spread over worker threads. Each match has its own
+// GameState and random seed, workers only share the read-only paths and
+// tower stats, so the results are the same for any number of threads.
+//
+// Usage: balancesim [-n matches] [-j threads] [-s seed] [-l order] [-r order] [-o prefix]
+//   order: "random" or tower types built in turn, e.g. "221" (0=super, 1=bat, 2=brown)
+// Writes <prefix>_waves.csv and <prefix>_towers.csv (prefix "balance" by default).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+
+#include "engine.h"
+
+#define BALANCE_MAX_WAVES 32    // Enemy HP grows per wave, 32 stays well inside an int
+#define BALANCE_MAX_THREADS 64
+#define BALANCE_MAX_ORDER 32
+#define BALANCE_NUM_TOWERS 3
+#define BALANCE_TOWERS_PER_SIDE (MAX_PLACED_BIRDS / 2) // Slots are shared, neither side may take them all
+#define BALANCE_PLACE_SPREAD 80 // Max distance from the path when placing at random
+
+typedef struct {
+    bool random;
+    int order[BALANCE_MAX_ORDER];
+    int length;
+} BuildOrder;
+
+// Summed over matches, one per worker, merged after the run
+typedef struct {
+    Uint64 matches;
+    Uint64 ticks;
+    Uint32 reached[BALANCE_MAX_WAVES];  // Sides alive when the wave started
+    Uint32 deaths[BALANCE_MAX_WAVES];   // Sides whose HP ran out during the wave
+    Uint64 leakedHp[BALANCE_MAX_WAVES]; // HP lost to enemies reaching the end
+    Uint32 survivors;                   // Sides still alive at BALANCE_MAX_WAVES
+    Uint64 survivalWaveSum[2];          // Per side (0 = left), for the average
+    Uint32 built[BALANCE_NUM_TOWERS];
+    Uint64 spent[BALANCE_NUM_TOWERS];
+    Uint64 damage[BALANCE_NUM_TOWERS];
+} BalanceStats;
+
+typedef struct {
+    GameResources *resources;   // Shared, the simulation only reads it
+    BuildOrder orders[2];
+    Uint32 seed;
+    int numMatches;
+    SDL_atomic_t nextMatch;     // Workers claim matches with SDL_AtomicAdd
+} BalanceRun;
+
+// Everything a worker writes, allocated separately so workers never share a cache line
+typedef struct {
+    BalanceRun *run;
+    GameState state;
+    BalanceStats stats;
+} BalanceWorker;
+
+// Per side while a match runs
+typedef struct {
+    int next;                   // Position in the order
+    int nextType;               // Tower to save up for
+    int built;
+    bool alive;
+} SideBuild;
+
+static Uint32 next_random(Uint32 *rng) {
+    Uint32 x = *rng; // xorshift32
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *rng = x;
+}
+
+static int random_range(Uint32 *rng, int lo, int hi) {
+    return lo + (int)(next_random(rng) % (Uint32)(hi - lo + 1));
+}
+
+static bool parse_order(const char *text, BuildOrder *order) {
+    memset(order, 0, sizeof *order);
+    if (strcmp(text, "random") == 0) {
+        order->random = true;
+        return true;
+    }
+    for (const char *c = text; *c; ++c) {
+        if (*c < '0' || *c >= '0' + BALANCE_NUM_TOWERS || order->length >= BALANCE_MAX_ORDER) return false;
+        order->order[order->length++] = *c - '0';
+    }
+    return order->length > 0;
+}
+
+static void pick_next(SideBuild *build, const BuildOrder *order, Uint32 *rng) {
+    if (order->random) {
+        build->nextType = random_range(rng, 0, BALANCE_NUM_TOWERS - 1);
+    } else {
+        build->nextType = order->order[build->next++ % order->length];
+    }
+}
+
+// Somewhere near the side's path, on the side's own half
+static void pick_spot(const Paths *paths, int side, Uint32 *rng, int *x, int *y) {
+    int numPoints = getNumPointsPaths(paths);
+    int segment = random_range(rng, 0, numPoints - 2);
+    SDL_Point a = side == 0 ? leftPointPaths(paths, segment) : rightPointPaths(paths, segment);
+    SDL_Point b = side == 0 ? leftPointPaths(paths, segment + 1) : rightPointPaths(paths, segment + 1);
+    float t = (float)(next_random(rng) % 1001) / 1000.0f;
+    *x = a.x + (int)((float)(b.x - a.x) * t) + random_range(rng, -BALANCE_PLACE_SPREAD, BALANCE_PLACE_SPREAD);
+    *y = a.y + (int)((float)(b.y - a.y) * t) + random_range(rng, -BALANCE_PLACE_SPREAD, BALANCE_PLACE_SPREAD);
+    int minX = side == 0 ? 20 : (int)(WINDOW_WIDTH * 0.55) + 1;
+    int maxX = side == 0 ? (int)(WINDOW_WIDTH * 0.45) - 1 : WINDOW_WIDTH - 20;
+    if (*x < minX) *x = minX;
+    if (*x > maxX) *x = maxX;
+    if (*y < 20) *y = 20;
+    if (*y > WINDOW_HEIGHT - 20) *y = WINDOW_HEIGHT - 20;
+}
+
+static void run_match(BalanceWorker *worker, int matchIndex) {
+    const BalanceRun *run = worker->run;
+    GameState *gs = &worker->state;
+    GameResources *res = run->resources;
+    BalanceStats *stats = &worker->stats;
+    const Audio silent = {0};
+    const float dt = 1.0f / GAME_TICK_RATE;
+
+    Uint32 rng = (run->seed ^ ((Uint32)matchIndex * 0x9E3779B9u)) | 1u;
+    for (int i = 0; i < 4; ++i) next_random(&rng); // Neighbouring seeds start far apart
+
+    game_state_reset(gs, res);
+    SideBuild sides[2] = {0};
+    for (int s = 0; s < 2; ++s) {
+        sides[s].alive = true;
+        pick_next(&sides[s], &run->orders[s], &rng);
+    }
+    int wave = -1;
+    Uint64 ticks = 0;
+    while ((sides[0].alive || sides[1].alive) && gs->currentWave < BALANCE_MAX_WAVES) {
+        if (gs->currentWave != wave) {
+            wave = gs->currentWave;
+            for (int s = 0; s < 2; ++s) {
+                if (sides[s].alive) stats->reached[wave]++;
+            }
+        }
+        // Build as soon as the next tower is affordable, player 0 is left and 1 right
+        for (int s = 0; s < 2; ++s) {
+            SideBuild *build = &sides[s];
+            if (!build->alive || build->built >= BALANCE_TOWERS_PER_SIDE) continue;
+            if (money_manager_get_balance(&gs->team_money[s == 0 ? TEAM_LEFT : TEAM_RIGHT])
+                < res->towerOptions[build->nextType].prototype.cost) continue;
+            int x, y;
+            pick_spot(res->paths, s, &rng, &x, &y);
+            if (place_tower(gs, res, build->nextType, x, y, s)) {
+                build->built++;
+                pick_next(build, &run->orders[s], &rng);
+            }
+        }
+
+        int hpBefore[2] = { gs->leftPlayerHP, gs->rightPlayerHP };
+        game_state_step(gs, res, &silent, dt);
+        ticks++;
+        int hpAfter[2] = { gs->leftPlayerHP, gs->rightPlayerHP };
+        for (int s = 0; s < 2; ++s) {
+            if (!sides[s].alive) continue;
+            stats->leakedHp[wave] += (Uint64)(hpBefore[s] - hpAfter[s]);
+            if (hpAfter[s] <= 0) {
+                sides[s].alive = false;
+                stats->deaths[wave]++;
+                stats->survivalWaveSum[s] += (Uint64)wave;
+            }
+        }
+    }
+
+    for (int s = 0; s < 2; ++s) {
+        if (!sides[s].alive) continue;
+        stats->survivors++;
+        stats->survivalWaveSum[s] += BALANCE_MAX_WAVES;
+    }
+    for (int i = 0; i < gs->numPlacedBirds; ++i) {
+        const Bird *bird = &gs->placedBirds[i];
+        if (bird->towerTypeIndex < 0 || bird->towerTypeIndex >= BALANCE_NUM_TOWERS) continue;
+        stats->built[bird->towerTypeIndex]++;
+        stats->spent[bird->towerTypeIndex] += (Uint64)bird->cost;
+        stats->damage[bird->towerTypeIndex] += (Uint64)bird->damageDealt;
+    }
+    stats->matches++;
+    stats->ticks += ticks;
+}
+
+static int worker_main(void *data) {
+    BalanceWorker *worker = data;
+    for (;;) {
+        int index = SDL_AtomicAdd(&worker->run->nextMatch, 1);
+        if (index >= worker->run->numMatches) break;
+        run_match(worker, index);
+    }
+    return 0;
+}
+
+static void merge_stats(BalanceStats *into, const BalanceStats *from) {
+    into->matches += from->matches;
+    into->ticks += from->ticks;
+    for (int w = 0; w < BALANCE_MAX_WAVES; ++w) {
+        into->reached[w] += from->reached[w];
+        into->deaths[w] += from->deaths[w];
+        into->leakedHp[w] += from->leakedHp[w];
+    }
+    into->survivors += from->survivors;
+    for (int s = 0; s < 2; ++s) into->survivalWaveSum[s] += from->survivalWaveSum[s];
+    for (int t = 0; t < BALANCE_NUM_TOWERS; ++t) {
+        into->built[t] += from->built[t];
+        into->spent[t] += from->spent[t];
+        into->damage[t] += from->damage[t];
+    }
+}
+
+static bool write_csv(const char *prefix, const BalanceStats *stats) {
+    char path[256];
+    snprintf(path, sizeof path, "%s_waves.csv", prefix);
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fprintf(f, "wave,sides_reached,deaths,leaked_hp,leaked_hp_per_side\n");
+    for (int w = 1; w < BALANCE_MAX_WAVES; ++w) {
+        if (stats->reached[w] == 0) break;
+        fprintf(f, "%d,%u,%u,%llu,%.2f\n", w, (unsigned)stats->reached[w], (unsigned)stats->deaths[w],
+                (unsigned long long)stats->leakedHp[w], (double)stats->leakedHp[w] / stats->reached[w]);
+    }
+    bool ok = fclose(f) == 0;
+
+    snprintf(path, sizeof path, "%s_towers.csv", prefix);
+    f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fprintf(f, "tower_type,built,money_spent,damage_dealt,damage_per_100_money\n");
+    for (int t = 0; t < BALANCE_NUM_TOWERS; ++t) {
+        fprintf(f, "%d,%u,%llu,%llu,%.2f\n", t, (unsigned)stats->built[t], (unsigned long long)stats->spent[t],
+                (unsigned long long)stats->damage[t],
+                stats->spent[t] ? (double)stats->damage[t] * 100.0 / (double)stats->spent[t] : 0.0);
+    }
+    return fclose(f) == 0 && ok;
+}
+
+int main(int argc, char *argv[]) {
+    int numMatches = 1000;
+    int numThreads = SDL_GetCPUCount();
+    Uint32 seed = 1;
+    const char *prefix = "balance";
+    BalanceRun run = {0};
+    parse_order("random", &run.orders[0]);
+    parse_order("random", &run.orders[1]);
+
+    for (int i = 1; i < argc; ++i) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        bool ok = value != NULL;
+        if (ok && strcmp(argv[i], "-n") == 0) numMatches = atoi(value);
+        else if (ok && strcmp(argv[i], "-j") == 0) numThreads = atoi(value);
+        else if (ok && strcmp(argv[i], "-s") == 0) seed = (Uint32)strtoul(value, NULL, 10);
+        else if (ok && strcmp(argv[i], "-l") == 0) ok = parse_order(value, &run.orders[0]);
+        else if (ok && strcmp(argv[i], "-r") == 0) ok = parse_order(value, &run.orders[1]);
+        else if (ok && strcmp(argv[i], "-o") == 0) prefix = value;
+        else ok = false;
+        if (!ok || numMatches <= 0) {
+            printf("Usage: %s [-n matches] [-j threads] [-s seed] [-l order] [-r order] [-o prefix]\n"
+                   "  order: \"random\" or tower types built in turn, e.g. \"221\" (0=super, 1=bat, 2=brown)\n", argv[0]);
+            return 1;
+        }
+        ++i;
+    }
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > BALANCE_MAX_THREADS) numThreads = BALANCE_MAX_THREADS;
+    if (numThreads > numMatches) numThreads = numMatches;
+
+    // Simulation data only, no window or textures
+    static GameResources resources;
+    if (!load_gameplay_data(&resources)) return 1;
+    gameplayLog = false; // Before any worker starts
+
+    run.resources = &resources;
+    run.seed = seed;
+    run.numMatches = numMatches;
+    SDL_AtomicSet(&run.nextMatch, 0);
+
+    BalanceWorker *workers[BALANCE_MAX_THREADS] = {0};
+    SDL_Thread *threads[BALANCE_MAX_THREADS] = {0};
+    int started = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < numThreads; ++i) {
+        workers[i] = calloc(1, sizeof *workers[i]);
+        if (!workers[i]) break;
+        workers[i]->run = &run;
+        threads[i] = SDL_CreateThread(worker_main, "BalanceWorker", workers[i]);
+        if (!threads[i]) {
+            printf("Failed to create worker: %s\n", SDL_GetError());
+            break;
+        }
+        started++;
+    }
+    if (started == 0 && workers[0]) worker_main(workers[0]); // No threads, run here
+
+    BalanceStats total = {0};
+    for (int i = 0; i < numThreads; ++i) {
+        if (threads[i]) SDL_WaitThread(threads[i], NULL);
+        if (workers[i]) merge_stats(&total, &workers[i]->stats);
+        free(workers[i]);
+    }
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    destroyPaths(resources.paths);
+
+    if (total.matches < (Uint64)numMatches) {
+        printf("Only %llu of %d matches ran.\n", (unsigned long long)total.matches, numMatches);
+        return 1;
+    }
+    double gameSeconds = (double)total.ticks / GAME_TICK_RATE;
+    printf("%d matches on %d threads in %.2f s: %.0f matches/s, %.0f ticks/s, %.0fx real time\n",
+           numMatches, started ? started : 1, seconds, numMatches / seconds, total.ticks / seconds, gameSeconds / seconds);
+    printf("Average survival wave: left %.2f, right %.2f (%u sides reached wave %d)\n",
+           (double)total.survivalWaveSum[0] / numMatches, (double)total.survivalWaveSum[1] / numMatches,
+           (unsigned)total.survivors, BALANCE_MAX_WAVES);
+    if (!write_csv(prefix, &total)) return 1;
+    printf("Wrote %s_waves.csv and %s_towers.csv\n", prefix, prefix);
+    return 0;
+}
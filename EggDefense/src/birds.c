@@ -7,17 +7,15 @@
 // Starts attack animation and plays sound
 static void begin_attack_animation(Bird *bird, const Audio *audio) {
     // Reset animation timer
-    bird->attackAnimTimer = 0.15f;
-    // Switch to attack texture
-    bird->texture = bird->attackTexture;
+    bird->attackAnimTimer = 0.15f; // Drawn with the attack texture meanwhile
     // Play sound effect
     play_sound(audio, audio->popSound);
 }
 
-// Applies damage to the target enemy
-static void apply_tower_damage(Enemy *target, const Bird *bird) {
+// Applies damage to the target enemy. No print here: this runs for every hit
+static void apply_tower_damage(Enemy *target, Bird *bird) {
+    bird->damageDealt += (bird->damage < target->hp) ? bird->damage : target->hp; // Overkill does not count
     target->hp -= bird->damage;
-    printf("Enemy type %d took %d damage, HP remaining: %d\n", target->type, bird->damage, target->hp);
     if (target->hp <= 0) {
         target->active = false;
     }
@@ -28,10 +26,10 @@ static void spawn_projectile(GameState *gameState, const Bird *bird, const Enemy
 {
     if (gameState->numProjectiles >= MAX_PROJECTILES) return;
     Projectile *newProj = &gameState->projectiles[gameState->numProjectiles++];
+    newProj->id = ++gameState->nextEntityId;
     newProj->active = true;
     newProj->x = bird->x;
     newProj->y = bird->y;
-    newProj->texture = bird->projectileTexture;
     newProj->textureIndex = bird->projectileTextureIndex;
 
     float dx = target->x - bird->x;
@@ -48,6 +46,101 @@ static void spawn_projectile(GameState *gameState, const Bird *bird, const Enemy
     }
 }
 
+// Enemies of one lane sorted by path progress, rebuilt every tick
+typedef struct {
+    float progress[MAX_ENEMIES];
+    int index[MAX_ENEMIES];
+    int count;
+} LaneOrder;
+
+static float enemy_progress(const Enemy *enemy) {
+    return (float)enemy->currentSegment + enemy->segmentProgress;
+}
+
+// Insertion sort: at most MAX_ENEMIES and mostly in order already. Equal
+// progress keeps the lowest enemy index last, like the old scan picked it.
+static void build_lane_orders(const GameState *gameState, LaneOrder lanes[2]) {
+    lanes[0].count = lanes[1].count = 0;
+    for (int j = 0; j < gameState->numEnemiesActive; j++) {
+        const Enemy *enemy = &gameState->enemies[j];
+        if (!enemy->active || enemy->side < 0 || enemy->side > 1) continue;
+        LaneOrder *lane = &lanes[enemy->side];
+        float progress = enemy_progress(enemy);
+        int k = lane->count++;
+        while (k > 0 && lane->progress[k - 1] >= progress) {
+            lane->progress[k] = lane->progress[k - 1];
+            lane->index[k] = lane->index[k - 1];
+            k--;
+        }
+        lane->progress[k] = progress;
+        lane->index[k] = j;
+    }
+}
+
+// Furthest enemy inside the intervals, -1 if none. Binary search per
+// interval from the far end; enemies killed earlier this tick are skipped.
+static int furthest_in_cover(const GameState *gameState, const LaneOrder *lane,
+                             const PathInterval *cover, int numCover)
+{
+    for (int c = numCover - 1; c >= 0; c--) {
+        int lo = 0, hi = lane->count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (lane->progress[mid] <= cover[c].to) lo = mid + 1;
+            else hi = mid;
+        }
+        for (int k = lo - 1; k >= 0 && lane->progress[k] >= cover[c].from; k--) {
+            if (gameState->enemies[lane->index[k]].active) return lane->index[k];
+        }
+    }
+    return -1;
+}
+
+// Distance scan over all enemies, for towers without cover
+static int furthest_in_range(const GameState *gameState, const Bird *bird) {
+    int target = -1;
+    float bestProgress = -1.0f;
+    bool birdIsLeft   = (bird->x < WINDOW_WIDTH * 0.48f);
+    bool birdIsRight  = (bird->x > WINDOW_WIDTH * 0.52f);
+    bool birdIsCenter = !birdIsLeft && !birdIsRight;
+
+    for (int j = 0; j < gameState->numEnemiesActive; j++) {
+        const Enemy *enemy = &gameState->enemies[j];
+        if (!enemy->active) continue;
+        if (!birdIsCenter) {
+            if (birdIsLeft && enemy->side != 0) continue;
+            if (birdIsRight && enemy->side != 1) continue;
+        }
+        float dist = distance_between_points(
+            bird->x, bird->y, enemy->x, enemy->y);
+        if (dist <= bird->range) {
+            float progress = enemy_progress(enemy);
+            if (progress > bestProgress) {
+                bestProgress = progress;
+                target = j;
+            }
+        }
+    }
+    return target;
+}
+
+// Which path intervals the range circle covers. Towers never move and the
+// paths are fixed, so this is done once when the tower is placed. Towers in
+// the middle shoot at both lanes and keep measuring distances.
+static void compute_tower_cover(Bird *bird, const Paths *paths) {
+    bool birdIsLeft  = (bird->x < WINDOW_WIDTH * 0.48f);
+    bool birdIsRight = (bird->x > WINDOW_WIDTH * 0.52f);
+    bird->hasCover = false;
+    bird->numCover = 0;
+    if (!birdIsLeft && !birdIsRight) return;
+    int side = birdIsLeft ? 0 : 1;
+    int n = circleCoveragePaths(paths, side, bird->x, bird->y, bird->range, bird->cover, BIRD_MAX_COVER);
+    if (n < 0) return; // Too winding for the table, measure instead
+    bird->hasCover = true;
+    bird->coverSide = (Uint8)side;
+    bird->numCover = (Uint8)n;
+}
+
 // Updates towers: target acquisition and firing
 void update_towers(GameState *gameState,
                    const Audio *audio,
@@ -56,6 +149,9 @@ void update_towers(GameState *gameState,
 {
     if (!gameState || dt <= 0 || !resources) return;
 
+    LaneOrder lanes[2];
+    build_lane_orders(gameState, lanes);
+
     for (int i = 0; i < gameState->numPlacedBirds; i++) {
         Bird *bird = &gameState->placedBirds[i];
         if (!bird->active) continue;
@@ -65,40 +161,17 @@ void update_towers(GameState *gameState,
             bird->attackAnimTimer -= dt;
             if (bird->attackAnimTimer <= 0) {
                 bird->attackAnimTimer = 0;
-                if (bird->baseTexture) {
-                    bird->texture = bird->baseTexture;
-                }
             }
         }
 
         // Increment attack cooldown
         bird->attackTimer += dt;
 
-        // Target acquisition
-        Enemy *target = NULL;
-        float bestProgress = -1.0f;
-        bool birdIsLeft   = (bird->x < WINDOW_WIDTH * 0.48f);
-        bool birdIsRight  = (bird->x > WINDOW_WIDTH * 0.52f);
-        bool birdIsCenter = !birdIsLeft && !birdIsRight;
-
-        for (int j = 0; j < gameState->numEnemiesActive; j++) {
-            Enemy *enemy = &gameState->enemies[j];
-            if (!enemy->active) continue;
-            if (!birdIsCenter) {
-                if (birdIsLeft && enemy->side != 0) continue;
-                if (birdIsRight && enemy->side != 1) continue;
-            }
-            float dist = distance_between_points(
-                bird->x, bird->y, enemy->x, enemy->y);
-            if (dist <= bird->range) {
-                float progress = (float)enemy->currentSegment +
-                                 enemy->segmentProgress;
-                if (progress > bestProgress) {
-                    bestProgress = progress;
-                    target = enemy;
-                }
-            }
-        }
+        // Target acquisition: furthest enemy along the path within range
+        int targetIndex = bird->hasCover
+            ? furthest_in_cover(gameState, &lanes[bird->coverSide], bird->cover, bird->numCover)
+            : furthest_in_range(gameState, bird);
+        Enemy *target = targetIndex >= 0 ? &gameState->enemies[targetIndex] : NULL;
 
         if (target && bird->attackTimer >= (1.0f / bird->attackSpeed)) {
             // Reset cooldown
@@ -107,9 +180,7 @@ void update_towers(GameState *gameState,
             apply_tower_damage(target, bird);
             // make enemy texture "step down" when taking damage
             if (target->hp > 0) {
-                if (target->hp <= 1) target->texture = resources->enemyTextures[0];
-                else if (target->hp <= 3) target->texture = resources->enemyTextures[1];
-                else target->texture = resources->enemyTextures[2];
+                target->spriteIndex = enemy_sprite_for_hp(target->hp);
             }
             spawn_projectile(gameState, bird, target);
         }
@@ -179,8 +250,8 @@ bool place_tower(GameState *gameState,
     int cost = option->prototype.cost;
 
     Team team = (ownerPlayerIndex == 0 || ownerPlayerIndex == 2) ? TEAM_LEFT : TEAM_RIGHT;
-    if (money_manager_get_balance(gameState->team_money[team]) < cost) {
-         printf("Cannot afford tower (cost %d, balance %d).\n", cost, money_manager_get_balance(gameState->team_money[team]));
+    if (money_manager_get_balance(&gameState->team_money[team]) < cost) {
+         if (gameplayLog) printf("Cannot afford tower (cost %d, balance %d).\n", cost, money_manager_get_balance(&gameState->team_money[team]));
          return false;
     }
 
@@ -188,7 +259,7 @@ bool place_tower(GameState *gameState,
     int rightBoundary = (int)(WINDOW_WIDTH * 0.55);
     if (x >= leftBoundary && x <= rightBoundary) return false;
 
-    if (!money_manager_spend(gameState->team_money[team], cost)) {
+    if (!money_manager_spend(&gameState->team_money[team], cost)) {
         printf("Spending %d failed unexpectedly.\n", cost);
         return false;
     }
@@ -201,10 +272,11 @@ bool place_tower(GameState *gameState,
     newBird->attackTimer      = 0.0f;
     newBird->attackAnimTimer  = 0.0f;
     newBird->rotation         = 0.0f;
-    newBird->texture          = newBird->baseTexture;
+    compute_tower_cover(newBird, resources->paths);
     gameState->numPlacedBirds++;
-    int newBalance = money_manager_get_balance(gameState->team_money[team]);
-    printf("Placed tower type %d at (%d,%d) by player %d. Money left: %d\n", towerTypeIndex, x, y, ownerPlayerIndex, newBalance);
+    gameState->towerVersion++;
+    int newBalance = money_manager_get_balance(&gameState->team_money[team]);
+    if (gameplayLog) printf("Placed tower type %d at (%d,%d) by player %d. Money left: %d\n", towerTypeIndex, x, y, ownerPlayerIndex, newBalance);
 
     return true;
 }
@@ -10,28 +10,72 @@
 #include <SDL2/SDL_ttf.h>
 #include "defs.h"
 #include "engine.h"
+#include "fragment.h"
+#include "locallink.h"
+#include "snapshot.h"
+#include "spectate.h"
 #include "paths.h"
+#include "renderqueue.h"
 
 // --- Static Function Prototypes ---
-static bool initialize_client(ClientInstance *client, const char *server_ip_str);
+static int run_client_session(AppContext *app, const char *server_ip_str, bool spectator);
+static bool initialize_client(ClientInstance *client, AppContext *app, const char *server_ip_str);
+static void send_join_packet(ClientInstance *client);
 static void run_client_loop(ClientInstance *client);
+static int client_logic_thread(void *data);
+static bool run_client_render_loop(ClientInstance *client);
+static void publish_render_frame(ClientInstance *client, bool quit);
 static void shutdown_client(ClientInstance *client);
-static void handle_server_packet(ClientInstance *client, UDPpacket *packet);
+static void receive_server_packets(ClientInstance *client);
+static void handle_server_datagram(ClientInstance *client, const Uint8 *data, int len);
+static void handle_snapshot_message(ClientInstance *client, const Uint8 *message, int len);
+static void handle_server_data(ClientInstance *client, const ServerPacketData *sd, const GameStateSnapshot *snapshot);
 static void update_status_text(ClientInstance *client, const char *message);
-static void apply_snapshot(ClientInstance *client, GameStateSnapshot *snapshot);
+static void apply_snapshot(ClientInstance *client, const GameStateSnapshot *snapshot);
 static void handle_client_click(ClientInstance *client, int clickX, int clickY);
+static void update_net_stats(ClientInstance *client, Uint32 now);
+static void toggle_stats_csv(ClientInstance *client);
+static void setup_net_conditioner(ClientInstance *client);
+static bool send_datagram(ClientInstance *client, const void *data, int len);
+static void flush_conditioned_sends(ClientInstance *client);
 
 // --- Public Entry Point ---
-int run_client(const char *server_ip_str)
+// server_ip_str == NULL connects to the server thread of this process (host mode)
+int run_client(AppContext *app, const char *server_ip_str)
+{
+    return run_client_session(app, server_ip_str, false);
+}
+
+// Read-only viewer of a server or relay, never takes a player slot
+int run_spectator(AppContext *app, const char *server_ip_str)
+{
+    if (!server_ip_str)
+        return 1;
+    return run_client_session(app, server_ip_str, true);
+}
+
+static int run_client_session(AppContext *app, const char *server_ip_str, bool spectator)
 {
     ClientInstance client = {0};
-    if (!initialize_client(&client, server_ip_str))
+    client.spectator = spectator;
+    if (!initialize_client(&client, app, server_ip_str))
     {
         printf("Client initialization failed. Exiting. Error: %s\n", client.statusText);
         shutdown_client(&client);
         return 1;
     }
-    run_client_loop(&client);
+    // SDL wants the window, its events and the renderer on the thread that
+    // created them, so this thread renders and the network runs beside it
+    SDL_Thread *logicThread = SDL_CreateThread(client_logic_thread, "ClientLogic", &client);
+    if (!logicThread)
+    {
+        printf("Failed to create client logic thread: %s\n", SDL_GetError());
+        shutdown_client(&client);
+        return 1;
+    }
+    if (run_client_render_loop(&client))
+        app->quit = true;
+    SDL_WaitThread(logicThread, NULL);
     shutdown_client(&client);
     printf("Client shut down.\n");
     return 0;
@@ -39,56 +83,59 @@ int run_client(const char *server_ip_str)
 
 
 // --- Initialization ---
-static bool initialize_client(ClientInstance *client, const char *server_ip_str)
+// Window, renderer and resources are the app's, already loaded
+static bool initialize_client(ClientInstance *client, AppContext *app, const char *server_ip_str)
 {
     printf("Initializing Client...\n");
     client->is_running = true;
     client->state = CLIENT_STATE_INIT;
     client->playerIndex = -1;
     snprintf(client->statusText, sizeof(client->statusText), "Initializing...");
-    if (!initialize_sdl(&client->window, &client->renderer, "Tower Defense - Client"))
-    {
-        snprintf(client->statusText, sizeof(client->statusText), "SDL Init Failed: %s", SDL_GetError());
-        return false;
-    }
-    if (!initialize_subsystems())
-    {
-        snprintf(client->statusText, sizeof(client->statusText), "SDL Subsystem Init Failed");
-        cleanup_sdl(client->window, client->renderer);
-        return false;
-    }
-    // Pass client's audio struct to load V1 sounds
-    if (!load_resources(client->renderer, &client->resources, &client->audio))
-    {
-        snprintf(client->statusText, sizeof(client->statusText), "Failed to load resources.");
-        cleanup_subsystems();
-        cleanup_sdl(client->window, client->renderer);
-        return false;
-    }
-    initialize_game_state(&client->localGameState, &client->resources);
+    client->window = app->window;
+    client->renderer = app->renderer;
+    client->resources = &app->resources;
+    client->audio = &app->audio;
+    SDL_SetWindowTitle(client->window, client->spectator ? "Tower Defense - Spectator" : "Tower Defense - Client");
+    initialize_game_state(&client->localGameState, client->resources);
     client->placingBird = false;
     client->selectedOption = -1;
     memset(client->birdRotations, 0, sizeof(client->birdRotations));
-    client->state = CLIENT_STATE_RESOLVING;
-    update_status_text(client, "Resolving server address...");
-    if (SDLNet_ResolveHost(&client->serverAddress, server_ip_str, SERVER_PORT) == -1)
-    {
-        snprintf(client->statusText, sizeof(client->statusText), "Error: ResolveHost: %s", SDLNet_GetError());
-        client->state = CLIENT_STATE_ERROR;
-        cleanup_resources(&client->resources, &client->audio);
-        cleanup_subsystems();
-        cleanup_sdl(client->window, client->renderer);
-        return false;
+    if (!server_ip_str)
+    {
+        // Host mode: the server runs on a thread in this process
+        client->useLocalLink = true;
+        client->serverAddress.host = LOCAL_LINK_HOST;
+        client->serverAddress.port = LOCAL_LINK_PORT;
+        printf("Client using in-process link to local server.\n");
     }
-    client->socket = SDLNet_UDP_Open(0);
-    if (!client->socket)
+    else
     {
-        snprintf(client->statusText, sizeof(client->statusText), "Error: UDP_Open: %s", SDLNet_GetError());
-        client->state = CLIENT_STATE_ERROR;
-        cleanup_resources(&client->resources, &client->audio);
-        cleanup_subsystems();
-        cleanup_sdl(client->window, client->renderer);
-        return false;
+        client->state = CLIENT_STATE_RESOLVING;
+        update_status_text(client, "Resolving server address...");
+        // "host:port" reaches servers/relays on other ports than SERVER_PORT
+        char host[128];
+        int port = SERVER_PORT;
+        snprintf(host, sizeof(host), "%s", server_ip_str);
+        char *colon = strrchr(host, ':');
+        if (colon && atoi(colon + 1) > 0)
+        {
+            port = atoi(colon + 1);
+            *colon = '\0';
+        }
+        if (SDLNet_ResolveHost(&client->serverAddress, host, (Uint16)port) == -1)
+        {
+            snprintf(client->statusText, sizeof(client->statusText), "Error: ResolveHost: %s", SDLNet_GetError());
+            client->state = CLIENT_STATE_ERROR;
+            return false;
+        }
+        client->socket = SDLNet_UDP_Open(0);
+        if (!client->socket)
+        {
+            snprintf(client->statusText, sizeof(client->statusText), "Error: UDP_Open: %s", SDLNet_GetError());
+            client->state = CLIENT_STATE_ERROR;
+            return false;
+        }
+        setup_net_conditioner(client);
     }
     client->packet_in = SDLNet_AllocPacket(PACKET_BUFFER_SIZE);
     client->packet_out = SDLNet_AllocPacket(PACKET_BUFFER_SIZE);
@@ -100,21 +147,73 @@ static bool initialize_client(ClientInstance *client, const char *server_ip_str)
         if (client->packet_out)
             SDLNet_FreePacket(client->packet_out);
         SDLNet_UDP_Close(client->socket);
-        cleanup_resources(&client->resources, &client->audio);
-        cleanup_subsystems();
-        cleanup_sdl(client->window, client->renderer);
         return false;
     }
     client->packet_out->address = client->serverAddress;
+    client->reassembler = reassembler_create();
+    if (!client->reassembler)
+    {
+        snprintf(client->statusText, sizeof(client->statusText), "Error: Failed to allocate reassembler");
+        SDLNet_FreePacket(client->packet_in);
+        SDLNet_FreePacket(client->packet_out);
+        SDLNet_UDP_Close(client->socket);
+        return false;
+    }
+    if (client->spectator)
+    {
+        client->spectatorView = spectator_view_create();
+        if (!client->spectatorView)
+        {
+            snprintf(client->statusText, sizeof(client->statusText), "Error: Failed to allocate spectator view");
+            return false; // shutdown_client frees the rest
+        }
+    }
+    client->renderQueue = render_queue_create();
+    if (!client->renderQueue)
+    {
+        snprintf(client->statusText, sizeof(client->statusText), "Error: Failed to allocate render queue");
+        return false; // shutdown_client frees the rest
+    }
     client->state = CLIENT_STATE_MAIN_MENU;
     client->lastReadySendTime = SDL_GetTicks();
     client->lastHeartbeatSendTime = SDL_GetTicks();
+    netstats_reset(&client->netStats, SDL_GetTicks());
     update_status_text(client, "Main Menu");
     printf("Client initialization complete. Showing Main Menu.\n");
     return true;
 }
 
-// --- Main Client Loop ---
+// --- Render Loop (main thread) ---
+// Draws the newest frame from the logic thread. Presenting blocks on vsync
+// here without holding up packet processing. Returns true if the window was
+// closed, so the app quits instead of going back to its menu.
+static bool run_client_render_loop(ClientInstance *client)
+{
+    bool closed = false;
+    while (true)
+    {
+        if (render_queue_pump_events(client->renderQueue, client->resources))
+            closed = true;
+        RenderFrame *frame = render_queue_acquire(client->renderQueue);
+        if (!frame)
+        {
+            SDL_Delay(1);
+            continue;
+        }
+        if (frame->quit)
+            break;
+        render_frame(client->renderer, client->resources, frame, MODE_CLIENT);
+    }
+    return closed;
+}
+
+static int client_logic_thread(void *data)
+{
+    run_client_loop((ClientInstance *)data);
+    return 0;
+}
+
+// --- Main Client Loop (logic thread) ---
 static void run_client_loop(ClientInstance *client)
 {
     while (client->is_running)
@@ -122,7 +221,7 @@ static void run_client_loop(ClientInstance *client)
         Uint32 currentTime = SDL_GetTicks();
 
         SDL_Event event;
-        while (SDL_PollEvent(&event))
+        while (render_queue_pop_input(client->renderQueue, &event))
         {
             if (event.type == SDL_QUIT)
             {
@@ -146,87 +245,90 @@ static void run_client_loop(ClientInstance *client)
                 else if (event.key.keysym.sym == SDLK_SPACE && client->state == CLIENT_STATE_MAIN_MENU)
                 {
                     client->state = CLIENT_STATE_CONNECTING;
-                    update_status_text(client, "Connecting...");
-                    ClientPacketData rp = {.command = CLIENT_CMD_READY, .playerIndex = -1};
-                    send_client_packet(client, &rp);
+                    update_status_text(client, client->spectator ? "Connecting as spectator..." : "Connecting...");
+                    send_join_packet(client);
+                    client->lastReadySendTime = currentTime;
+                }
+                else if (event.key.keysym.sym == SDLK_SPACE && client->state == CLIENT_STATE_GAME_OVER && !client->spectator)
+                {
+                    // Rematch: READY again, the server restarts once every player has
+                    game_state_reset(&client->localGameState, client->resources);
+                    memset(client->birdRotations, 0, sizeof(client->birdRotations));
+                    client->gameOverMessage[0] = '\0';
+                    client->state = CLIENT_STATE_WAITING_FOR_START;
+                    update_status_text(client, "Waiting for rematch...");
+                    send_join_packet(client);
                     client->lastReadySendTime = currentTime;
                 }
+                else if (event.key.keysym.sym == SDLK_F3)
+                {
+                    client->showNetStats = !client->showNetStats;
+                }
+                else if (event.key.keysym.sym == SDLK_F5)
+                {
+                    toggle_stats_csv(client);
+                }
             }
-            if (client->state >= CLIENT_STATE_RUNNING && client->state < CLIENT_STATE_GAME_OVER)
+            if (!client->spectator && client->state >= CLIENT_STATE_RUNNING && client->state < CLIENT_STATE_GAME_OVER)
             {
                 if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT)
                 {
                     handle_client_click(client, event.button.x, event.button.y);
                 }
             }
-        } // End PollEvent
+        } // End input
 
         if (!client->is_running)
             break;
 
+        update_net_stats(client, currentTime);
+        flush_conditioned_sends(client);
+
         // --- State Machine & Network ---
         switch (client->state)
         {
         case CLIENT_STATE_MAIN_MENU:
-            render_main_menu(client->renderer, &client->resources, MODE_CLIENT);
             break;
         case CLIENT_STATE_CONNECTING:
             if (currentTime - client->lastReadySendTime > CLIENT_READY_INTERVAL)
             {
-                ClientPacketData rp = {.command = CLIENT_CMD_READY, .playerIndex = -1};
-                send_client_packet(client, &rp);
+                send_join_packet(client);
                 client->lastReadySendTime = currentTime;
             }
-            while (SDLNet_UDP_Recv(client->socket, client->packet_in) > 0)
-            {
-                if (client->packet_in->address.host == client->serverAddress.host && client->packet_in->address.port == client->serverAddress.port)
-                    handle_server_packet(client, client->packet_in);
-            }
-            SDL_SetRenderDrawColor(client->renderer, 0, 0, 0, 255);
-            SDL_RenderClear(client->renderer);
-            render_text(client->renderer, client->resources.font, client->statusText, 10, WINDOW_HEIGHT - 30, (SDL_Color){255, 255, 255, 255}, false);
-            SDL_RenderPresent(client->renderer);
+            receive_server_packets(client);
             break;
         case CLIENT_STATE_WAITING_FOR_START: // Fallthrough
         case CLIENT_STATE_RUNNING:
-            if (currentTime - client->lastHeartbeatSendTime > CLIENT_HEARTBEAT_INTERVAL)
+            if (client->spectator)
+            {
+                if (currentTime - client->lastSpectateSendTime > SPECTATOR_KEEPALIVE_INTERVAL)
+                {
+                    send_join_packet(client);
+                    client->lastSpectateSendTime = currentTime;
+                }
+            }
+            else if (client->state == CLIENT_STATE_WAITING_FOR_START &&
+                     currentTime - client->lastReadySendTime > CLIENT_READY_INTERVAL)
+            {
+                // READY is idempotent on the server, resent in case a rematch request was lost
+                send_join_packet(client);
+                client->lastReadySendTime = currentTime;
+            }
+            else if (currentTime - client->lastHeartbeatSendTime > CLIENT_HEARTBEAT_INTERVAL)
             {
                 ClientPacketData hbp = {.command = CLIENT_CMD_HEARTBEAT, .playerIndex = client->playerIndex};
                 send_client_packet(client, &hbp);
                 client->lastHeartbeatSendTime = currentTime;
             }
-            while (SDLNet_UDP_Recv(client->socket, client->packet_in) > 0)
-            {
-                if (client->packet_in->address.host == client->serverAddress.host && client->packet_in->address.port == client->serverAddress.port)
-                    handle_server_packet(client, client->packet_in);
-            }
+            receive_server_packets(client);
             calculate_tower_rotations(&client->localGameState, client->birdRotations);
-            SDL_SetRenderDrawColor(client->renderer, 0, 0, 0, 255);
-            SDL_RenderClear(client->renderer);
-            render_game(client->renderer, &client->localGameState, &client->resources, client->birdRotations, client->placingBird, client->selectedOption, client->playerIndex);
-            render_text(client->renderer, client->resources.font, client->statusText, 10, WINDOW_HEIGHT - 30, (SDL_Color){255, 255, 255, 255}, false);
-            SDL_RenderPresent(client->renderer);
             break;
         case CLIENT_STATE_GAME_OVER:
-            while (SDLNet_UDP_Recv(client->socket, client->packet_in) > 0)
-            {
-                if (client->packet_in->address.host == client->serverAddress.host && client->packet_in->address.port == client->serverAddress.port)
-                    handle_server_packet(client, client->packet_in);
-            }
+            receive_server_packets(client);
             calculate_tower_rotations(&client->localGameState, client->birdRotations);
-            SDL_SetRenderDrawColor(client->renderer, 0, 0, 0, 255);
-            SDL_RenderClear(client->renderer);
-            render_game(client->renderer, &client->localGameState, &client->resources, client->birdRotations, false, -1, client->playerIndex);
-            render_game_over(client->renderer, &client->resources, client->gameOverMessage);
-            SDL_RenderPresent(client->renderer);
             break;
         case CLIENT_STATE_DISCONNECTED: // Fallthrough
         case CLIENT_STATE_ERROR:
-            SDL_SetRenderDrawColor(client->renderer, 0, 0, 0, 255);
-            SDL_RenderClear(client->renderer);
-            render_text(client->renderer, client->resources.font, client->statusText, WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2, (SDL_Color){255, 0, 0, 255}, true);
-            render_text(client->renderer, client->resources.font, "Press ESC to quit", WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2 + 30, (SDL_Color){255, 255, 255, 255}, true);
-            SDL_RenderPresent(client->renderer);
             break;
         case CLIENT_STATE_INIT: // Fallthrough
         case CLIENT_STATE_RESOLVING:
@@ -234,11 +336,55 @@ static void run_client_loop(ClientInstance *client)
             client->state = CLIENT_STATE_ERROR;
             break;
         }
+        publish_render_frame(client, false);
         SDL_Delay(1);
     }
+    publish_render_frame(client, true);
     printf("Client loop finished.\n");
 }
 
+// Copies everything the render thread draws into the next render frame
+static void publish_render_frame(ClientInstance *client, bool quit)
+{
+    RenderFrame *frame = render_queue_begin(client->renderQueue);
+    frame->quit = quit;
+    switch (client->state)
+    {
+    case CLIENT_STATE_MAIN_MENU:
+        frame->view = RENDER_VIEW_MENU;
+        break;
+    case CLIENT_STATE_CONNECTING:
+        frame->view = RENDER_VIEW_STATUS;
+        break;
+    case CLIENT_STATE_WAITING_FOR_START: // Fallthrough
+    case CLIENT_STATE_RUNNING:
+        frame->view = RENDER_VIEW_GAME;
+        break;
+    case CLIENT_STATE_GAME_OVER:
+        frame->view = RENDER_VIEW_GAME_OVER;
+        break;
+    default:
+        frame->view = RENDER_VIEW_ERROR;
+        break;
+    }
+    if (frame->view == RENDER_VIEW_GAME || frame->view == RENDER_VIEW_GAME_OVER)
+    {
+        frame->state = client->localGameState; // Pointer-free, a plain copy
+        memcpy(frame->birdRotations, client->birdRotations, sizeof(frame->birdRotations));
+    }
+    frame->placingBird = client->placingBird;
+    frame->selectedOption = client->selectedOption;
+    frame->playerIndex = client->playerIndex;
+    frame->stepCounter = 0; // Snapshots are drawn as they arrive
+    snprintf(frame->statusText, sizeof(frame->statusText), "%s", client->statusText);
+    snprintf(frame->overlayText, sizeof(frame->overlayText), "%s", client->gameOverMessage);
+    frame->canRematch = !client->spectator;
+    frame->netStatsLine[0] = '\0';
+    if (client->showNetStats)
+        netstats_format(&client->netStats, frame->netStatsLine, sizeof(frame->netStatsLine));
+    render_queue_publish(client->renderQueue);
+}
+
 // --- Client Click Handling Logic ---
 static void handle_client_click(ClientInstance *client, int clickX, int clickY)
 {
@@ -252,7 +398,7 @@ static void handle_client_click(ClientInstance *client, int clickX, int clickY)
         // Välj torn-ikon
         for (int i = 0; i < 3; ++i)
         {
-            SDL_Rect ir = client->resources.towerOptions[i].iconRect;
+            SDL_Rect ir = client->resources->towerOptions[i].iconRect;
             if (clickX >= ir.x && clickX <= ir.x + ir.w
              && clickY >= ir.y && clickY <= ir.y + ir.h)
             {
@@ -303,20 +449,117 @@ static void handle_client_click(ClientInstance *client, int clickX, int clickY)
 
 
 // --- Networking Helpers ---
-static void handle_server_packet(ClientInstance *client, UDPpacket *packet)
+static void receive_server_packets(ClientInstance *client)
 {
-    if (!client || !packet || (size_t)packet->len < sizeof(ServerCommandType))
+    if (client->useLocalLink)
+    {
+        // Host player: small messages from the ring, the newest snapshot read in place
+        Uint8 buf[LOCAL_LINK_SLOT_SIZE];
+        int len;
+        while ((len = locallink_client_recv(buf, sizeof(buf))) > 0)
+        {
+            netstats_on_receive(&client->netStats, len);
+            handle_server_datagram(client, buf, len);
+        }
+        ServerPacketData hdr;
+        memset(&hdr, 0, SERVER_PACKET_HEADER_SIZE);
+        const GameStateSnapshot *snapshot = locallink_snapshot_take(&hdr.command);
+        if (snapshot)
+            handle_server_data(client, &hdr, snapshot);
+        return;
+    }
+
+    while (SDLNet_UDP_Recv(client->socket, client->packet_in) > 0)
+    {
+        if (client->packet_in->address.host != client->serverAddress.host || client->packet_in->address.port != client->serverAddress.port)
+            continue;
+        if (client->condIn)
+        {
+            netcond_push(client->condIn, client->packet_in->address, client->packet_in->data, client->packet_in->len, SDL_GetTicks());
+            continue;
+        }
+        netstats_on_receive(&client->netStats, client->packet_in->len);
+        handle_server_datagram(client, client->packet_in->data, client->packet_in->len);
+    }
+    if (client->condIn)
+    {
+        // Impaired datagrams whose delay has run out
+        const Uint8 *data;
+        int len = 0;
+        while ((data = netcond_pop(client->condIn, SDL_GetTicks(), NULL, &len)) != NULL)
+        {
+            netstats_on_receive(&client->netStats, len);
+            handle_server_datagram(client, data, len);
+        }
+    }
+    // Snapshots with lost fragments: use whatever leading part arrived
+    int len = 0;
+    const Uint8 *partial;
+    while ((partial = reassembler_expire(client->reassembler, SDL_GetTicks(), &len)) != NULL)
+    {
+        handle_snapshot_message(client, partial, len);
+    }
+}
+
+static void handle_server_datagram(ClientInstance *client, const Uint8 *data, int len)
+{
+    if (!client || !data || (size_t)len < sizeof(ServerCommandType))
+        return;
+    ServerCommandType command;
+    memcpy(&command, data, sizeof(command));
+    if (command == SERVER_CMD_FRAGMENT)
+    {
+        int msgLen = 0;
+        const Uint8 *message = reassembler_accept(client->reassembler, data, len, SDL_GetTicks(), &msgLen);
+        if (message)
+            handle_snapshot_message(client, message, msgLen);
+        return;
+    }
+    ServerPacketData sd;
+    size_t cs = ((size_t)len < SERVER_PACKET_HEADER_SIZE) ? (size_t)len : SERVER_PACKET_HEADER_SIZE;
+    memset(&sd, 0, sizeof(ServerPacketData));
+    memcpy(&sd, data, cs);
+    netstats_on_stamp(&client->netStats, &sd.stamp, SDL_GetTicks());
+    handle_server_data(client, &sd, NULL);
+}
+
+// Reassembled message: packet header followed by a wire-format snapshot
+static void handle_snapshot_message(ClientInstance *client, const Uint8 *message, int len)
+{
+    if (len < (int)SERVER_PACKET_HEADER_SIZE)
         return;
     ServerPacketData sd;
-    size_t cs = ((size_t)packet->len < sizeof(ServerPacketData)) ? (size_t)packet->len : sizeof(ServerPacketData);
     memset(&sd, 0, sizeof(ServerPacketData));
-    memcpy(&sd, packet->data, cs);
-    switch (sd.command)
+    memcpy(&sd, message, SERVER_PACKET_HEADER_SIZE);
+    netstats_on_stamp(&client->netStats, &sd.stamp, SDL_GetTicks());
+    netstats_on_snapshot(&client->netStats, len);
+    const Uint8 *body = message + SERVER_PACKET_HEADER_SIZE;
+    int bodyLen = len - (int)SERVER_PACKET_HEADER_SIZE;
+    if (sd.command == SERVER_CMD_SPECTATOR_FRAME)
+    {
+        // Keyframe or delta; deltas without their keyframe are skipped
+        if (!client->spectatorView || !spectator_view_apply(client->spectatorView, body, bodyLen, &sd.snapshot))
+            return;
+    }
+    else if (!snapshot_decode(body, bodyLen, &sd.snapshot))
+        return;
+    if (sd.snapshot.stateHash && snapshot_hash(&sd.snapshot) != sd.snapshot.stateHash)
+    {
+        if (client->hashMismatches++ == 0)
+            printf("CLIENT: Snapshot checksum mismatch (expected %08x, decoded %08x), state differs from the server's\n",
+                   (unsigned)sd.snapshot.stateHash, (unsigned)snapshot_hash(&sd.snapshot));
+    }
+    handle_server_data(client, &sd, &sd.snapshot);
+}
+
+static void handle_server_data(ClientInstance *client, const ServerPacketData *sd, const GameStateSnapshot *snapshot)
+{
+    switch (sd->command)
     {
     case SERVER_CMD_ASSIGN_INDEX:
         if (client->state == CLIENT_STATE_CONNECTING)
         {
-            client->playerIndex = sd.assignedPlayerIndex;
+            client->playerIndex = sd->assignedPlayerIndex;
             client->state = CLIENT_STATE_WAITING_FOR_START;
             char s[64];
             snprintf(s, sizeof(s), "Connected as P%d. Waiting...", client->playerIndex + 1);
@@ -327,7 +570,7 @@ static void handle_server_packet(ClientInstance *client, UDPpacket *packet)
         if (client->state == CLIENT_STATE_WAITING_FOR_START)
         {
             char s[64];
-            snprintf(s, sizeof(s), "Waiting... (%d/%d Ready)", sd.clientsConnected, MAX_PLAYERS);
+            snprintf(s, sizeof(s), "Waiting... (%d/%d Ready)", sd->clientsConnected, MAX_PLAYERS);
             update_status_text(client, s);
         }
         break;
@@ -336,30 +579,27 @@ static void handle_server_packet(ClientInstance *client, UDPpacket *packet)
         {
             client->state = CLIENT_STATE_RUNNING;
             update_status_text(client, "Game Running!");
-            play_music(client->audio.bgm);
+            play_music(client->audio->bgm);
         }
         break;
         case SERVER_CMD_STATE_UPDATE:
         if (client->state == CLIENT_STATE_RUNNING ||
             client->state == CLIENT_STATE_WAITING_FOR_START)
         {
-            if ((size_t)packet->len >=
-                offsetof(ServerPacketData, snapshot) + sizeof(GameStateSnapshot))
-            {
-                apply_snapshot(client, &sd.snapshot);
-            }
-            else
+            if (!snapshot)
             {
-                printf("Warn: STATE_UPDATE packet too small (%d bytes)\n", packet->len);
+                printf("Warn: STATE_UPDATE without snapshot data\n");
+                break;
             }
+            apply_snapshot(client, snapshot);
 
-            if (sd.snapshot.gameOver && client->state != CLIENT_STATE_GAME_OVER)
+            if (snapshot->gameOver && client->state != CLIENT_STATE_GAME_OVER)
             {
                 client->state = CLIENT_STATE_GAME_OVER;
                 bool leftTeam    = (client->playerIndex == 0 || client->playerIndex == 2);
                 bool teamVictory =
-                    (sd.snapshot.winner == 0 && leftTeam) ||
-                    (sd.snapshot.winner == 1 && !leftTeam);
+                    (snapshot->winner == 0 && leftTeam) ||
+                    (snapshot->winner == 1 && !leftTeam);
                 snprintf(client->gameOverMessage,
                          sizeof(client->gameOverMessage),
                          teamVictory ? "YOU WIN!" : "YOU LOSE!");
@@ -373,15 +613,15 @@ static void handle_server_packet(ClientInstance *client, UDPpacket *packet)
         if (client->state != CLIENT_STATE_GAME_OVER)
         {
             client->state = CLIENT_STATE_GAME_OVER;
-            if ((size_t)packet->len >=
-                offsetof(ServerPacketData, snapshot) + sizeof(GameStateSnapshot))
+            if (snapshot)
             {
-                apply_snapshot(client, &sd.snapshot);
+                apply_snapshot(client, snapshot);
             }
+            int winner       = snapshot ? snapshot->winner : client->localGameState.winner;
             bool leftTeam    = (client->playerIndex == 0 || client->playerIndex == 2);
             bool teamVictory =
-                (sd.snapshot.winner == 0 && leftTeam) ||
-                (sd.snapshot.winner == 1 && !leftTeam);
+                (winner == 0 && leftTeam) ||
+                (winner == 1 && !leftTeam);
             snprintf(client->gameOverMessage,
                      sizeof(client->gameOverMessage),
                      teamVictory ? "YOU WIN!" : "YOU LOSE!");
@@ -391,6 +631,28 @@ static void handle_server_packet(ClientInstance *client, UDPpacket *packet)
         break;
 
     
+    case SERVER_CMD_SPECTATOR_FRAME:
+        if (!client->spectator || !snapshot)
+            break;
+        if (client->state == CLIENT_STATE_GAME_OVER && snapshot->gameOver)
+            break;
+        // First frame, or the first frame of a rematch
+        if (client->state == CLIENT_STATE_CONNECTING || client->state == CLIENT_STATE_GAME_OVER)
+        {
+            client->state = CLIENT_STATE_RUNNING;
+            update_status_text(client, "Spectating");
+            play_music(client->audio->bgm);
+        }
+        apply_snapshot(client, snapshot);
+        if (snapshot->gameOver)
+        {
+            client->state = CLIENT_STATE_GAME_OVER;
+            snprintf(client->gameOverMessage, sizeof(client->gameOverMessage),
+                     snapshot->winner == 0 ? "LEFT TEAM WINS!" : "RIGHT TEAM WINS!");
+            update_status_text(client, "Game Over");
+            stop_music();
+        }
+        break;
     case SERVER_CMD_REJECT_FULL:
         if (client->state == CLIENT_STATE_CONNECTING)
         {
@@ -405,26 +667,76 @@ static void handle_server_packet(ClientInstance *client, UDPpacket *packet)
         printf("CLIENT: Server rejected tower placement.\n");
         break;
     default:
-        printf("Warn: Unknown command %d received from server.\n", sd.command);
+        printf("Warn: Unknown command %d received from server.\n", sd->command);
         break;
     }
 }
 void send_client_packet(ClientInstance *client, ClientPacketData *data)
 {
-    if (!client || !data || !client->socket || !client->packet_out || client->state == CLIENT_STATE_ERROR || client->state == CLIENT_STATE_DISCONNECTED)
+    if (!client || !data || client->state == CLIENT_STATE_ERROR || client->state == CLIENT_STATE_DISCONNECTED)
         return;
-    client->packet_out->len = sizeof(ClientPacketData);
-    memcpy(client->packet_out->data, data, client->packet_out->len);
+    netstats_stamp(&client->netStats, &data->stamp, SDL_GetTicks());
+    netstats_on_send(&client->netStats, (int)sizeof(ClientPacketData), 1);
+    if (client->useLocalLink)
+    {
+        if (!locallink_client_send(data, sizeof(ClientPacketData)))
+            printf("Warn: local link full, dropped cmd %d\n", data->command);
+        return;
+    }
+    if (client->condOut)
+    {
+        // Leaves from flush_conditioned_sends once its delay has run out
+        netcond_push(client->condOut, client->serverAddress, data, sizeof(ClientPacketData), SDL_GetTicks());
+        return;
+    }
+    if (!send_datagram(client, data, sizeof(ClientPacketData)))
+        printf("Warn: send failed (cmd %d)\n", data->command);
+}
+
+static bool send_datagram(ClientInstance *client, const void *data, int len)
+{
+    if (!client->socket || !client->packet_out || len > client->packet_out->maxlen)
+        return false;
+    client->packet_out->len = len;
+    memcpy(client->packet_out->data, data, (size_t)len);
     if (SDLNet_UDP_Send(client->socket, -1, client->packet_out) == 0)
     {
-        printf("Warn: SDLNet_UDP_Send failed (cmd %d): %s\n", data->command, SDLNet_GetError());
+        printf("Warn: SDLNet_UDP_Send failed: %s\n", SDLNet_GetError());
         update_status_text(client, "Error Sending Packet - Disconnected?");
         client->state = CLIENT_STATE_DISCONNECTED;
+        return false;
     }
+    return true;
+}
+
+static void flush_conditioned_sends(ClientInstance *client)
+{
+    if (!client->condOut)
+        return;
+    const Uint8 *data;
+    int len = 0;
+    while ((data = netcond_pop(client->condOut, SDL_GetTicks(), NULL, &len)) != NULL)
+    {
+        if (!send_datagram(client, data, len))
+            break;
+    }
+}
+
+// EGG_NETCOND impairs both directions to the server (one conditioner each)
+static void setup_net_conditioner(ClientInstance *client)
+{
+    NetConditionerConfig cfg;
+    if (!netcond_config_from_env(&cfg))
+        return;
+    if (!netcond_create_pair(&cfg, &client->condOut, &client->condIn))
+        return;
+    printf("Network conditioner on: delay %u+%u ms, loss %.1f%%, dup %.1f%%, reorder %.1f%%, seed %u\n",
+           (unsigned)cfg.delayMs, (unsigned)cfg.jitterMs, cfg.lossPercent,
+           cfg.duplicatePercent, cfg.reorderPercent, (unsigned)cfg.seed);
 }
 
 // Applies snapshot to local state AND plays sound if projectiles increased
-static void apply_snapshot(ClientInstance *client, GameStateSnapshot *snapshot)
+static void apply_snapshot(ClientInstance *client, const GameStateSnapshot *snapshot)
 {
     if (!client || !snapshot)
         return;
@@ -436,7 +748,7 @@ static void apply_snapshot(ClientInstance *client, GameStateSnapshot *snapshot)
     // --- Apply Snapshot Data ---
     Team team = (client->playerIndex == 0 || client->playerIndex == 2) ? TEAM_LEFT : TEAM_RIGHT;
     money_manager_set_balance(
-    local->team_money[team],
+    &local->team_money[team],
     snapshot->money
 );
     local->leftPlayerHP = snapshot->leftPlayerHP;
@@ -453,17 +765,15 @@ static void apply_snapshot(ClientInstance *client, GameStateSnapshot *snapshot)
         local->enemies[i].angle = snapshot->enemies[i].angle;
         local->enemies[i].type = snapshot->enemies[i].type;
         local->enemies[i].hp = snapshot->enemies[i].hp;
-        if (local->enemies[i].hp > 0) {
-            if (local->enemies[i].hp <= 1) local->enemies[i].texture = client->resources.enemyTextures[0];
-            else if (local->enemies[i].hp <= 3) local->enemies[i].texture = client->resources.enemyTextures[1];
-            else local->enemies[i].texture = client->resources.enemyTextures[2];
-        }
+        if (local->enemies[i].hp > 0)
+            local->enemies[i].spriteIndex = enemy_sprite_for_hp(local->enemies[i].hp);
         local->enemies[i].active = snapshot->enemies[i].active;
         local->enemies[i].side = snapshot->enemies[i].side;
     }
     for (int i = local->numEnemiesActive; i < MAX_ENEMIES; ++i)
         local->enemies[i].active = false;
     // Towers
+    if (local->numPlacedBirds != snapshot->numPlacedBirds) local->towerVersion++; // Towers are never moved
     local->numPlacedBirds = snapshot->numPlacedBirds;
     for (int i = 0; i < local->numPlacedBirds; ++i)
     {
@@ -475,19 +785,9 @@ static void apply_snapshot(ClientInstance *client, GameStateSnapshot *snapshot)
         local->placedBirds[i].attackAnimTimer = snapshot->placedBirds[i].attackAnimTimer;
         if (local->placedBirds[i].towerTypeIndex >= 0 && local->placedBirds[i].towerTypeIndex < 3)
         {
-            const Bird *pt = &client->resources.towerOptions[local->placedBirds[i].towerTypeIndex].prototype;
-            local->placedBirds[i].baseTexture = pt->baseTexture;
-            local->placedBirds[i].attackTexture = pt->attackTexture;
-            local->placedBirds[i].projectileTexture = pt->projectileTexture;
+            const Bird *pt = &client->resources->towerOptions[local->placedBirds[i].towerTypeIndex].prototype;
             local->placedBirds[i].projectileTextureIndex = pt->projectileTextureIndex;
             local->placedBirds[i].range = pt->range;
-            local->placedBirds[i].texture = (local->placedBirds[i].attackAnimTimer > 0) ? local->placedBirds[i].attackTexture : local->placedBirds[i].baseTexture;
-        }
-        else
-        {
-            local->placedBirds[i].texture = NULL;
-            local->placedBirds[i].baseTexture = NULL;
-            local->placedBirds[i].attackTexture = NULL;
         }
     }
     for (int i = local->numPlacedBirds; i < MAX_PLACED_BIRDS; ++i)
@@ -501,10 +801,6 @@ static void apply_snapshot(ClientInstance *client, GameStateSnapshot *snapshot)
         local->projectiles[i].angle = snapshot->projectiles[i].angle;
         local->projectiles[i].active = snapshot->projectiles[i].active;
         local->projectiles[i].textureIndex = snapshot->projectiles[i].projectileTextureIndex;
-        if (local->projectiles[i].textureIndex >= 0 && local->projectiles[i].textureIndex < 2)
-            local->projectiles[i].texture = client->resources.projectileTextures[local->projectiles[i].textureIndex];
-        else
-            local->projectiles[i].texture = NULL;
     }
     for (int i = local->numProjectiles; i < MAX_PROJECTILES; ++i)
         local->projectiles[i].active = false;
@@ -514,7 +810,7 @@ static void apply_snapshot(ClientInstance *client, GameStateSnapshot *snapshot)
     // assume at least one projectile was fired and play the sound.
     if (local->numProjectiles > oldProjectileCount)
     {
-        play_sound(&client->audio, client->audio.popSound);
+        play_sound(client->audio, client->audio->popSound);
     }
 }
 
@@ -530,17 +826,70 @@ static void shutdown_client(ClientInstance *client)
     printf("Shutting down client...\n");
     if (!client)
         return;
+    if (client->statsCsv)
+        fclose(client->statsCsv);
+    client->statsCsv = NULL;
     if (client->packet_in)
         SDLNet_FreePacket(client->packet_in);
     if (client->packet_out)
         SDLNet_FreePacket(client->packet_out);
     if (client->socket)
         SDLNet_UDP_Close(client->socket);
+    reassembler_destroy(client->reassembler);
+    netcond_destroy(client->condIn);
+    netcond_destroy(client->condOut);
+    spectator_view_destroy(client->spectatorView);
+    client->spectatorView = NULL;
+    render_queue_destroy(client->renderQueue);
+    client->renderQueue = NULL;
+    client->condIn = NULL;
+    client->condOut = NULL;
     client->packet_in = NULL;
     client->packet_out = NULL;
     client->socket = NULL;
-    cleanup_resources(&client->resources, &client->audio);
-    cleanup_sdl(client->window, client->renderer);
-    cleanup_subsystems();
+    client->reassembler = NULL;
+    stop_music(); // Window and resources stay with the app
     printf("Client shutdown complete.\n");
-}
\ No newline at end of file
+}
+
+// READY for players, SPECTATE for viewers (also their keepalive)
+static void send_join_packet(ClientInstance *client)
+{
+    ClientPacketData jp = {
+        .command = client->spectator ? CLIENT_CMD_SPECTATE : CLIENT_CMD_READY,
+        .playerIndex = -1
+    };
+    send_client_packet(client, &jp);
+}
+
+// --- Network Statistics ---
+static void update_net_stats(ClientInstance *client, Uint32 now)
+{
+    netstats_update(&client->netStats, now);
+    if (client->statsCsv && now - client->lastStatsCsvTime >= NETSTATS_CSV_INTERVAL)
+    {
+        client->lastStatsCsvTime = now;
+        netstats_write_csv_row(client->statsCsv, now, client->useLocalLink ? "local" : "server", &client->netStats);
+        fflush(client->statsCsv);
+    }
+}
+
+static void toggle_stats_csv(ClientInstance *client)
+{
+    if (client->statsCsv)
+    {
+        fclose(client->statsCsv);
+        client->statsCsv = NULL;
+        printf("Network stats export stopped.\n");
+        return;
+    }
+    client->statsCsv = fopen("netstats_client.csv", "w");
+    if (!client->statsCsv)
+    {
+        perror("netstats_client.csv");
+        return;
+    }
+    netstats_write_csv_header(client->statsCsv);
+    client->lastStatsCsvTime = 0;
+    printf("Exporting network stats to netstats_client.csv\n");
+}
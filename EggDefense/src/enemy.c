@@ -8,10 +8,10 @@ static float newCords(float a, float b, float t) {
     return a + (b - a) * t;
 }
 
-void update_enemies(GameState *gameState, float dt) {
-    if (!gameState || dt <= 0.0f) return;
+void update_enemies(GameState *gameState, const GameResources *resources, float dt) {
+    if (!gameState || !resources || dt <= 0.0f) return;
 
-    Paths *paths = gameState->paths;          
+    const Paths *paths = resources->paths;
     int numPoints = getNumPointsPaths(paths);
 
     for (int i = 0; i < gameState->numEnemiesActive; ) {
@@ -75,10 +75,17 @@ void update_enemies(GameState *gameState, float dt) {
        (gameState->leftPlayerHP <= 0 || gameState->rightPlayerHP <= 0)) {
         gameState->gameOver = true;
         gameState->winner   = (gameState->leftPlayerHP <= 0) ? 1 : 0;
-        printf("GAME OVER Condition Met (Detected in update_enemies).\n");
+        if (gameplayLog) printf("GAME OVER Condition Met (Detected in update_enemies).\n");
     }
 }
 
+// Damaged enemies "step down" to a weaker-looking sprite
+int enemy_sprite_for_hp(int hp) {
+    if (hp <= 1) return 0;
+    if (hp <= 3) return 1;
+    return 2;
+}
+
 void spawn_enemy_pair(GameState *gameState, GameResources *resources) {
     if (!gameState || !resources ||
         gameState->numEnemiesActive > MAX_ENEMIES - 2) {
@@ -104,15 +111,16 @@ void spawn_enemy_pair(GameState *gameState, GameResources *resources) {
 
     int hp = baseHp;
 
-    SDL_Texture *tex;
-    if (hp <= 4)       tex = resources->enemyTextures[0];
-    else if (hp <= 8)  tex = resources->enemyTextures[1];
-    else               tex = resources->enemyTextures[2];
+    int spriteIndex;
+    if (hp <= 4)       spriteIndex = 0;
+    else if (hp <= 8)  spriteIndex = 1;
+    else               spriteIndex = 2;
 
     float speed = 150.0f;
-    Paths *paths = gameState->paths;
+    const Paths *paths = resources->paths;
 
     Enemy *eL = &gameState->enemies[gameState->numEnemiesActive++];
+    eL->id              = ++gameState->nextEntityId;
     eL->active          = true;
     eL->side            = 0;
     eL->type            = type;
@@ -126,9 +134,10 @@ void spawn_enemy_pair(GameState *gameState, GameResources *resources) {
         eL->y      = (float)start.y;
     }
     eL->angle   = 0.0f;
-    eL->texture = tex;
+    eL->spriteIndex = spriteIndex;
 
     Enemy *eR = &gameState->enemies[gameState->numEnemiesActive++];
+    eR->id              = ++gameState->nextEntityId;
     eR->active          = true;
     eR->side            = 1;
     eR->type            = type;
@@ -142,5 +151,5 @@ void spawn_enemy_pair(GameState *gameState, GameResources *resources) {
         eR->y      = (float)start.y;
     }
     eR->angle   = 0.0f;
-    eR->texture = tex;
+    eR->spriteIndex = spriteIndex;
 }
@@ -2,6 +2,7 @@
 #include <string.h> 
 #include <math.h>   
 #include "engine.h" 
+#include "assetloader.h"
 
 // Initializes SDL Core, Window, and Renderer
 bool initialize_sdl(SDL_Window **window, SDL_Renderer **renderer, const char* title) {
@@ -66,143 +67,213 @@ bool initialize_subsystems() {
     return true;
 }
 
-// Initializes Audio
-bool initialize_audio(Audio *audio) {
-    if (!audio) return false;
-    memset(audio, 0, sizeof(Audio)); 
-
-    // Background Music
-    audio->bgm = Mix_LoadMUS("resources/gamesound.mp3");
-    if (!audio->bgm) {
-        printf("Warning: Failed to load BGM 'resources/gamesound.mp3': %s\n", Mix_GetError());
-    } else {
-        Mix_VolumeMusic(64); // default volume
-        printf("BGM Loaded.\n");
+// Helper to load a single texture
+SDL_Texture* load_texture(SDL_Renderer *renderer, const char *path) {
+    SDL_Texture *texture = IMG_LoadTexture(renderer, path);
+    if (!texture) {
+        printf("Error loading texture '%s': %s\n", path, IMG_GetError());
     }
+    return texture;
+}
 
-    // Load Sound Effect
-    audio->popSound = Mix_LoadWAV("resources/pop.wav");
-    if (!audio->popSound) {
-        printf("Warning: Failed to load SFX 'resources/pop.wav': %s\n", Mix_GetError());
-    } else {
-         printf("SFX Loaded.\n");
+// Creates a texture from a decoded surface and frees the surface
+static SDL_Texture* texture_from_surface(SDL_Renderer *renderer, SDL_Surface *surface, const char *path) {
+    if (!surface) return NULL; // Decode error already printed
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        printf("Error creating texture for '%s': %s\n", path, SDL_GetError());
     }
+    return texture;
+}
 
-    audio->levelUpSound = Mix_LoadWAV("resources/levelup.wav");
-    if (!audio->levelUpSound) {
-        printf("Warning: Failed to load SFX 'resources/levelup.wav': %s\n", Mix_GetError());
-    } else {
-         printf("SFX Loaded.\n");
-    }
+// Files found in the asset pack are taken from there, only the rest is
+// queued for decoding. Returns the job id, or -1 for packed files.
+static int queue_asset(AssetLoader *loader, const AssetPack *pack, AssetKind kind, const char *path) {
+    if (asset_pack_find(pack, path)) return -1;
+    return asset_loader_add(loader, kind, path);
+}
 
-    return true;
+static SDL_Surface* take_image(AssetLoader *loader, const AssetPack *pack, int job, const char *path) {
+    return job < 0 ? asset_pack_surface(pack, path) : asset_loader_take(loader, job);
+}
 
+static Mix_Chunk* take_sound(AssetLoader *loader, const AssetPack *pack, int job, const char *path) {
+    if (job >= 0) return asset_loader_take(loader, job);
+    SDL_RWops *rw = asset_pack_rw(pack, path);
+    return rw ? Mix_LoadWAV_RW(rw, 1) : NULL;
 }
 
-// Helper to load a single texture
-SDL_Texture* load_texture(SDL_Renderer *renderer, const char *path) {
-    SDL_Texture *texture = IMG_LoadTexture(renderer, path);
-    if (!texture) {
-        printf("Error loading texture '%s': %s\n", path, IMG_GetError());
-    }
-    return texture;
+static Mix_Music* take_music(AssetLoader *loader, const AssetPack *pack, int job, const char *path) {
+    if (job >= 0) return asset_loader_take(loader, job);
+    SDL_RWops *rw = asset_pack_rw(pack, path); // Streams from the pack while playing
+    return rw ? Mix_LoadMUS_RW(rw, 1) : NULL;
 }
 
-// Loads all necessary game resources
+// Loads all necessary game resources, showing the loading screen meanwhile
 bool load_resources(SDL_Renderer *renderer, GameResources *resources, Audio *audio) {
+    return load_resources_with_progress(renderer, resources, audio, render_loading_screen);
+}
+
+// Paths and tower stats: everything the simulation reads, nothing that
+// needs a renderer. Headless tools call this instead of load_resources.
+bool load_gameplay_data(GameResources *resources) {
+    if (!resources) return false;
+    resources->paths = createPaths();
+    if (!resources->paths) {
+        printf("Error: Failed to create paths.\n");
+        return false;
+    }
+
+    // Define Tower Options
+    // Superbird (Type 0)
+    Bird p0 = { .damage = 1, .range = WINDOW_WIDTH * 0.1f, .attackSpeed = 5.0f, .cost = 1000,
+                .projectileTextureIndex = 1, // Bullet
+                .towerTypeIndex = 0, .ownerPlayerIndex = -1 };
+                resources->towerOptions[0] = (TowerOption){ .prototype = p0, .iconSprite = &resources->towerIconSprites[0] };
+
+    // Batbird (Type 1)
+    Bird p1 = { .damage = 10, .range = WINDOW_WIDTH * 0.1f, .attackSpeed = 0.5f, .cost = 400,
+                .projectileTextureIndex = 0, // Dart
+                .towerTypeIndex = 1, .ownerPlayerIndex = -1 };
+                resources->towerOptions[1] = (TowerOption){ .prototype = p1, .iconSprite = &resources->towerIconSprites[1] };
+
+    // Brownbird (Type 2)
+    Bird p2 = { .damage = 3, .range = WINDOW_WIDTH * 0.16f, .attackSpeed = 1.2f, .cost = 200,
+                .projectileTextureIndex = 0, // Dart
+                .towerTypeIndex = 2, .ownerPlayerIndex = -1 };
+                resources->towerOptions[2] = (TowerOption){ .prototype = p2, .iconSprite = &resources->towerIconSprites[2] };
+    return true;
+}
+
+// Images come pre-decoded from the asset pack when there is one (make pack).
+// Files not in it are decoded on the asset loader's workers; this thread
+// uploads the textures and reports progress each time one more file is done
+bool load_resources_with_progress(SDL_Renderer *renderer, GameResources *resources, Audio *audio, LoadProgressFn progress) {
     if (!renderer || !resources || !audio) return false;
 
     printf("Loading resources...\n");
     memset(resources, 0, sizeof(GameResources)); // Clear struct first
+    memset(audio, 0, sizeof(Audio));
     bool success = true;
-
-    // Load Textures
-    resources->mapTexture = load_texture(renderer, "resources/map.png");
-    if (!resources->mapTexture) success = false;
-
-    resources->mainMenuBg = load_texture(renderer, "resources/MainMenuPic3.png");
-     if (!resources->mainMenuBg) {
-        printf("CRITICAL ERROR: Main menu background 'resources/MainMenuPic3.png' not found!\n");
+    resources->pack = asset_pack_open(ASSET_PACK_PATH);
+    const AssetPack *pack = resources->pack;
+    if (!load_gameplay_data(resources)) success = false;
+
+    // Gameplay sprites go into a shared atlas so they can be batched together
+    struct { const char *path; Sprite *out; } atlasFiles[] = {
+        { "resources/shadow.png", &resources->shadow },
+        // Enemies
+        { "resources/redbloon.png", &resources->enemySprites[0] },
+        { "resources/bluebloon.png", &resources->enemySprites[1] },
+        { "resources/yellowbloon.png", &resources->enemySprites[2] },
+        // Projectiles
+        { "resources/dart.png", &resources->projectileSprites[0] },   // Index 0 = Dart
+        { "resources/bullet.png", &resources->projectileSprites[1] }, // Index 1 = Bullet
+        // Tower Base Sprites
+        { "resources/superbird1.png", &resources->towerBaseSprites[0] }, // Index 0 = Super
+        { "resources/batbird1.png", &resources->towerBaseSprites[1] },   // Index 1 = Bat
+        { "resources/brownbird1.png", &resources->towerBaseSprites[2] }, // Index 2 = Brown
+        // Tower Attack Sprites
+        { "resources/superbird1attack.png", &resources->towerAttackSprites[0] },
+        { "resources/batbird1attack.png", &resources->towerAttackSprites[1] },
+        { "resources/brownbird1attack.png", &resources->towerAttackSprites[2] },
+        // Tower Icon Sprites
+        { "resources/superbird1icon.png", &resources->towerIconSprites[0] },
+        { "resources/batbird1icon.png", &resources->towerIconSprites[1] },
+        { "resources/brownbird1icon.png", &resources->towerIconSprites[2] },
+    };
+    enum { NUM_ATLAS_FILES = sizeof(atlasFiles) / sizeof(atlasFiles[0]) };
+    int atlasJobs[NUM_ATLAS_FILES];
+
+    AssetLoader *loader = asset_loader_create();
+    if (!loader) {
+        printf("Error: Failed to create asset loader.\n");
+        return false;
+    }
+    // Menu background first, the loading screen shows it as soon as it is in
+    int menuJob = queue_asset(loader, pack, ASSET_IMAGE, "resources/MainMenuPic3.png");
+    int mapJob  = queue_asset(loader, pack, ASSET_IMAGE, "resources/map.png");
+    for (int i = 0; i < NUM_ATLAS_FILES; i++) {
+        atlasJobs[i] = queue_asset(loader, pack, ASSET_IMAGE, atlasFiles[i].path);
+    }
+    int bgmJob     = queue_asset(loader, pack, ASSET_MUSIC, "resources/gamesound.mp3");
+    int popJob     = queue_asset(loader, pack, ASSET_SOUND, "resources/pop.wav");
+    int levelUpJob = queue_asset(loader, pack, ASSET_SOUND, "resources/levelup.wav");
+    asset_loader_start(loader, 0);
+
+    // While the workers decode: everything that needs the renderer or TTF
+    resources->spriteBatch = spritebatch_create(renderer);
+    if (!resources->spriteBatch) {
+        printf("Error: Failed to create sprite batch.\n");
         success = false;
-     }
+    }
 
-    resources->shadow = IMG_LoadTexture(renderer, "resources/shadow.png");
-    if (!resources->shadow) {
-        printf("CRITICAL ERROR: shadow 'resources/shadow.png' not found!\n");
-        success = false;
-     }
+    // Static background layer (render target, optional)
+    if (SDL_RenderTargetSupported(renderer)) {
+        resources->staticLayer.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                                           SDL_TEXTUREACCESS_TARGET, WINDOW_WIDTH, WINDOW_HEIGHT);
+        if (!resources->staticLayer.texture) {
+            printf("Warning: No static layer, drawing the map every frame: %s\n", SDL_GetError());
+        }
+    }
 
-    // Enemies
-    resources->enemyTextures[0] = load_texture(renderer, "resources/redbloon.png");
-    if (!resources->enemyTextures[0]) success = false;
-    resources->enemyTextures[1] = load_texture(renderer, "resources/bluebloon.png");
-    if (!resources->enemyTextures[1]) success = false;
-    resources->enemyTextures[2] = load_texture(renderer, "resources/yellowbloon.png");
-    if (!resources->enemyTextures[2]) success = false;
-
-    // Projectiles
-    resources->projectileTextures[0] = load_texture(renderer, "resources/dart.png"); // Index 0 = Dart
-    if (!resources->projectileTextures[0]) success = false;
-    resources->projectileTextures[1] = load_texture(renderer, "resources/bullet.png"); // Index 1 = Bullet
-    if (!resources->projectileTextures[1]) success = false;
-
-    // Tower Base Textures
-    resources->towerBaseTextures[0] = load_texture(renderer, "resources/superbird1.png"); // Index 0 = Super
-    if (!resources->towerBaseTextures[0]) success = false;
-    resources->towerBaseTextures[1] = load_texture(renderer, "resources/batbird1.png");   // Index 1 = Bat
-    if (!resources->towerBaseTextures[1]) success = false;
-    resources->towerBaseTextures[2] = load_texture(renderer, "resources/brownbird1.png"); // Index 2 = Brown
-    if (!resources->towerBaseTextures[2]) success = false;
-
-    // Tower Attack Textures
-    resources->towerAttackTextures[0] = load_texture(renderer, "resources/superbird1attack.png");
-    if (!resources->towerAttackTextures[0]) success = false;
-    resources->towerAttackTextures[1] = load_texture(renderer, "resources/batbird1attack.png");
-    if (!resources->towerAttackTextures[1]) success = false;
-    resources->towerAttackTextures[2] = load_texture(renderer, "resources/brownbird1attack.png");
-    if (!resources->towerAttackTextures[2]) success = false;
-
-    // Tower Icon Textures
-    resources->towerIconTextures[0] = load_texture(renderer, "resources/superbird1icon.png");
-    if (!resources->towerIconTextures[0]) success = false;
-    resources->towerIconTextures[1] = load_texture(renderer, "resources/batbird1icon.png");
-    if (!resources->towerIconTextures[1]) success = false;
-    resources->towerIconTextures[2] = load_texture(renderer, "resources/brownbird1icon.png");
-    if (!resources->towerIconTextures[2]) success = false;
-
-    // Load Font
-    resources->font = TTF_OpenFont("resources/font.ttf", 24);
+    // Load Font (read lazily, so a packed font keeps using the pack)
+    SDL_RWops *fontRw = asset_pack_rw(pack, "resources/font.ttf");
+    resources->font = fontRw ? TTF_OpenFontRW(fontRw, 1, 24) : TTF_OpenFont("resources/font.ttf", 24);
     if (!resources->font) {
         printf("TTF_OpenFont Error for 'resources/font.ttf': %s\n", TTF_GetError());
         success = false;
+    } else {
+        resources->textCache = text_cache_create(renderer, resources->font);
+        if (!resources->textCache) success = false;
     }
 
-    // Initialize Audio
-    if (!initialize_audio(audio)) {
-         printf("Audio initialization finished with warnings.\n");
+    // Wait for the decodes, the menu background is uploaded as soon as it is ready
+    int total = asset_loader_count(loader);
+    int done = 0;
+    bool menuUploaded = false;
+    while (true) {
+        // A packed background is there right away
+        if (!menuUploaded && (menuJob < 0 || asset_loader_done(loader, menuJob))) {
+            menuUploaded = true;
+            resources->mainMenuBg = texture_from_surface(renderer, take_image(loader, pack, menuJob, "resources/MainMenuPic3.png"), "resources/MainMenuPic3.png");
+            if (!resources->mainMenuBg) {
+                printf("CRITICAL ERROR: Main menu background 'resources/MainMenuPic3.png' not found!\n");
+                success = false;
+            }
+        }
+        if (progress) progress(renderer, resources, done, total);
+        if (done >= total) break;
+        done = asset_loader_wait_next(loader);
     }
 
-    // Define Tower Options
-    // Superbird (Type 0)
-    Bird p0 = { .damage = 1, .range = WINDOW_WIDTH * 0.1f, .attackSpeed = 5.0f, .cost = 1000,
-                .projectileTexture = resources->projectileTextures[1], .projectileTextureIndex = 1, // Bullet
-                .baseTexture = resources->towerBaseTextures[0], .attackTexture = resources->towerAttackTextures[0],
-                .texture = resources->towerBaseTextures[0], .towerTypeIndex = 0, .ownerPlayerIndex = -1 };
-                resources->towerOptions[0] = (TowerOption){ .prototype = p0, .iconTexture = resources->towerIconTextures[0] };
+    // Load Textures
+    resources->mapTexture = texture_from_surface(renderer, take_image(loader, pack, mapJob, "resources/map.png"), "resources/map.png");
+    if (!resources->mapTexture) success = false;
 
-    // Batbird (Type 1)
-    Bird p1 = { .damage = 10, .range = WINDOW_WIDTH * 0.1f, .attackSpeed = 0.5f, .cost = 400,
-                .projectileTexture = resources->projectileTextures[0], .projectileTextureIndex = 0, // Dart
-                .baseTexture = resources->towerBaseTextures[1], .attackTexture = resources->towerAttackTextures[1],
-                .texture = resources->towerBaseTextures[1], .towerTypeIndex = 1, .ownerPlayerIndex = -1 };
-                resources->towerOptions[1] = (TowerOption){ .prototype = p1, .iconTexture = resources->towerIconTextures[1] };
+    AtlasBuilder *atlas = atlas_builder_create();
+    if (!atlas) {
+        printf("Error: Failed to create atlas builder.\n");
+        success = false;
+    } else {
+        for (int i = 0; i < NUM_ATLAS_FILES; i++) {
+            if (!atlas_builder_add_surface(atlas, take_image(loader, pack, atlasJobs[i], atlasFiles[i].path), atlasFiles[i].out)) success = false;
+        }
+        if (!resources->shadow.w) {
+            printf("CRITICAL ERROR: shadow 'resources/shadow.png' not found!\n");
+        }
+        resources->numAtlasPages = atlas_builder_build(atlas, renderer, resources->atlasPages, ATLAS_MAX_PAGES);
+        if (resources->numAtlasPages == 0) success = false;
+        atlas_builder_destroy(atlas);
+    }
 
-    // Brownbird (Type 2)
-    Bird p2 = { .damage = 3, .range = WINDOW_WIDTH * 0.16f, .attackSpeed = 1.2f, .cost = 200,
-                .projectileTexture = resources->projectileTextures[0], .projectileTextureIndex = 0, // Dart
-                .baseTexture = resources->towerBaseTextures[2], .attackTexture = resources->towerAttackTextures[2],
-                .texture = resources->towerBaseTextures[2], .towerTypeIndex = 2, .ownerPlayerIndex = -1 };
-                resources->towerOptions[2] = (TowerOption){ .prototype = p2, .iconTexture = resources->towerIconTextures[2] };
+    // Audio, missing files are only warnings
+    audio->bgm          = take_music(loader, pack, bgmJob, "resources/gamesound.mp3");
+    audio->popSound     = take_sound(loader, pack, popJob, "resources/pop.wav");
+    audio->levelUpSound = take_sound(loader, pack, levelUpJob, "resources/levelup.wav");
+    if (audio->bgm) Mix_VolumeMusic(64); // default volume
+    asset_loader_destroy(loader);
 
     // Layout UI Icons
     int spacing = 20;
@@ -210,8 +281,9 @@ bool load_resources(SDL_Renderer *renderer, GameResources *resources, Audio *aud
     int icon_w = 0, icon_h = 0;
 
     for (int i = 0; i < 3; i++) {
-        if (resources->towerOptions[i].iconTexture) {
-             SDL_QueryTexture(resources->towerOptions[i].iconTexture, NULL, NULL, &icon_w, &icon_h);
+        if (resources->towerOptions[i].iconSprite->texture) {
+             icon_w = resources->towerOptions[i].iconSprite->w;
+             icon_h = resources->towerOptions[i].iconSprite->h;
              resources->towerOptions[i].iconRect.w = icon_w / ICON_SCALE_DIVISOR;
              resources->towerOptions[i].iconRect.h = icon_h / ICON_SCALE_DIVISOR;
         } else {
@@ -247,19 +319,23 @@ void cleanup_resources(GameResources *resources, Audio *audio) {
     // Textures
     if (resources->mapTexture) SDL_DestroyTexture(resources->mapTexture);
     if (resources->mainMenuBg) SDL_DestroyTexture(resources->mainMenuBg);
-    for (int i = 0; i < 3; i++) if (resources->enemyTextures[i]) SDL_DestroyTexture(resources->enemyTextures[i]);
-    for (int i = 0; i < 2; i++) if (resources->projectileTextures[i]) SDL_DestroyTexture(resources->projectileTextures[i]);
-    for (int i = 0; i < 3; i++) if (resources->towerBaseTextures[i]) SDL_DestroyTexture(resources->towerBaseTextures[i]);
-    for (int i = 0; i < 3; i++) if (resources->towerAttackTextures[i]) SDL_DestroyTexture(resources->towerAttackTextures[i]);
-    for (int i = 0; i < 3; i++) if (resources->towerIconTextures[i]) SDL_DestroyTexture(resources->towerIconTextures[i]);
+    if (resources->staticLayer.texture) SDL_DestroyTexture(resources->staticLayer.texture);
+    for (int i = 0; i < resources->numAtlasPages; i++) SDL_DestroyTexture(resources->atlasPages[i]); // All gameplay sprites
+
+    spritebatch_destroy(resources->spriteBatch);
 
     // Font
+    text_cache_destroy(resources->textCache);
     if (resources->font) TTF_CloseFont(resources->font);
 
     // Audio 
     if (audio->popSound) Mix_FreeChunk(audio->popSound);
     if (audio->bgm) Mix_FreeMusic(audio->bgm);
 
+    // Font and music above read from it
+    asset_pack_close(resources->pack);
+    destroyPaths(resources->paths);
+
     memset(resources, 0, sizeof(GameResources));
     memset(audio, 0, sizeof(Audio));
 
@@ -285,6 +361,53 @@ void cleanup_sdl(SDL_Window *window, SDL_Renderer *renderer) {
     printf("SDL Core cleaned up.\n");
 }
 
+// Everything the program needs for its whole run, in one go. The loading
+// screen shows in the window while the resources load.
+bool app_init(AppContext *app, const char *title) {
+    if (!app) return false;
+    memset(app, 0, sizeof(AppContext));
+    if (!initialize_sdl(&app->window, &app->renderer, title)) return false;
+    if (!initialize_subsystems()) {
+        cleanup_sdl(app->window, app->renderer);
+        return false;
+    }
+    if (!load_resources(app->renderer, &app->resources, &app->audio)) {
+        cleanup_resources(&app->resources, &app->audio);
+        cleanup_subsystems();
+        cleanup_sdl(app->window, app->renderer);
+        return false;
+    }
+    return true;
+}
+
+void app_shutdown(AppContext *app) {
+    if (!app) return;
+    stop_music();
+    cleanup_resources(&app->resources, &app->audio);
+    cleanup_subsystems();
+    cleanup_sdl(app->window, app->renderer);
+    app->window = NULL;
+    app->renderer = NULL;
+}
+
+// The host's server thread simulates with the same sprites and tower options
+// as its client but must not touch what the render thread owns (textures,
+// font, static layer). The paths stay shared, they are never written after
+// loading.
+void share_gameplay_resources(GameResources *dst, const GameResources *src) {
+    if (!dst || !src) return;
+    *dst = *src;
+    dst->mapTexture = NULL;
+    dst->mainMenuBg = NULL;
+    dst->font = NULL;
+    memset(dst->atlasPages, 0, sizeof(dst->atlasPages));
+    dst->numAtlasPages = 0;
+    dst->spriteBatch = NULL;
+    dst->textCache = NULL;
+    memset(&dst->staticLayer, 0, sizeof(dst->staticLayer));
+    dst->pack = NULL;
+}
+
 
 // Audio Playback Functions
 void play_sound(const Audio *audio, Mix_Chunk* sound) {
@@ -0,0 +1,152 @@
+// fragment.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fragment.h"
+
+// --- Sending ---
+
+int fragment_send(Transport *t, IPaddress address, uint16_t messageId, const void *data, int len) {
+    if (!t || !data || len <= 0) return 0;
+    if (len > FRAGMENT_MAX_MESSAGE_SIZE) {
+        printf("Warn: message of %d bytes exceeds fragment limit (%d)\n", len, FRAGMENT_MAX_MESSAGE_SIZE);
+        return 0;
+    }
+
+    int count = (len + FRAGMENT_PAYLOAD_SIZE - 1) / FRAGMENT_PAYLOAD_SIZE;
+    Uint8 datagram[NET_MTU_PAYLOAD];
+    const Uint8 *bytes = data;
+
+    for (int i = 0; i < count; ++i) {
+        int offset = i * FRAGMENT_PAYLOAD_SIZE;
+        int chunk  = (len - offset < FRAGMENT_PAYLOAD_SIZE) ? len - offset : FRAGMENT_PAYLOAD_SIZE;
+        FragmentHeader hdr = {
+            .command       = SERVER_CMD_FRAGMENT,
+            .messageId     = messageId,
+            .fragmentIndex = (uint8_t)i,
+            .fragmentCount = (uint8_t)count,
+            .payloadSize   = (uint16_t)chunk
+        };
+        memcpy(datagram, &hdr, sizeof hdr);
+        memcpy(datagram + sizeof hdr, bytes + offset, (size_t)chunk);
+        transport_send(t, address, datagram, (int)sizeof hdr + chunk);
+    }
+    return count;
+}
+
+// --- Reassembly ---
+
+typedef struct {
+    bool used;
+    uint16_t messageId;
+    int count;
+    Uint32 receivedMask;  // Bit i set when fragment i has arrived
+    int lastSize;         // Payload size of the final fragment
+    Uint32 firstSeen;     // SDL_GetTicks() of the first fragment
+    Uint8 data[FRAGMENT_MAX_MESSAGE_SIZE];
+} ReassemblySlot;
+
+// Intern representation
+struct Reassembler {
+    ReassemblySlot slots[FRAGMENT_REASSEMBLY_SLOTS];
+    bool hasDelivered;
+    uint16_t lastDeliveredId;
+};
+
+Reassembler *reassembler_create(void) {
+    Reassembler *r = calloc(1, sizeof *r);
+    if (!r) perror("Failed to allocate reassembler");
+    return r;
+}
+
+void reassembler_destroy(Reassembler *r) {
+    free(r);
+}
+
+// True if id is not newer than the last delivered message (wraps at 16 bits)
+static bool is_stale(const Reassembler *r, uint16_t id) {
+    return r->hasDelivered && (int16_t)(id - r->lastDeliveredId) <= 0;
+}
+
+// Marks a message as delivered and drops everything older, since a newer
+// state supersedes it anyway
+static void mark_delivered(Reassembler *r, uint16_t id) {
+    r->hasDelivered    = true;
+    r->lastDeliveredId = id;
+    for (int i = 0; i < FRAGMENT_REASSEMBLY_SLOTS; ++i) {
+        if (r->slots[i].used && is_stale(r, r->slots[i].messageId)) {
+            r->slots[i].used = false;
+        }
+    }
+}
+
+static ReassemblySlot *find_or_claim_slot(Reassembler *r, uint16_t id, int count, Uint32 now) {
+    ReassemblySlot *free_slot = NULL;
+    ReassemblySlot *oldest    = NULL;
+    for (int i = 0; i < FRAGMENT_REASSEMBLY_SLOTS; ++i) {
+        ReassemblySlot *s = &r->slots[i];
+        if (s->used && s->messageId == id) return s;
+        if (!s->used && !free_slot) free_slot = s;
+        if (s->used && (!oldest || (int16_t)(s->messageId - oldest->messageId) < 0)) oldest = s;
+    }
+    ReassemblySlot *s = free_slot ? free_slot : oldest;
+    s->used         = true;
+    s->messageId    = id;
+    s->count        = count;
+    s->receivedMask = 0;
+    s->lastSize     = 0;
+    s->firstSeen    = now;
+    return s;
+}
+
+const Uint8 *reassembler_accept(Reassembler *r, const Uint8 *data, int len, Uint32 now, int *outLen) {
+    if (!r || !data || !outLen || len < (int)sizeof(FragmentHeader)) return NULL;
+
+    FragmentHeader hdr;
+    memcpy(&hdr, data, sizeof hdr);
+    int payload = len - (int)sizeof hdr;
+    if (hdr.command != SERVER_CMD_FRAGMENT ||
+        hdr.fragmentCount == 0 || hdr.fragmentCount > FRAGMENT_MAX_COUNT ||
+        hdr.fragmentIndex >= hdr.fragmentCount ||
+        hdr.payloadSize != payload || payload > FRAGMENT_PAYLOAD_SIZE) {
+        return NULL;
+    }
+    // Every fragment but the last is full-sized, which fixes its offset
+    bool isLast = (hdr.fragmentIndex == hdr.fragmentCount - 1);
+    if (!isLast && payload != FRAGMENT_PAYLOAD_SIZE) return NULL;
+    if (is_stale(r, hdr.messageId)) return NULL;
+
+    ReassemblySlot *s = find_or_claim_slot(r, hdr.messageId, hdr.fragmentCount, now);
+    if (s->count != hdr.fragmentCount) return NULL;
+
+    memcpy(s->data + hdr.fragmentIndex * FRAGMENT_PAYLOAD_SIZE, data + sizeof hdr, (size_t)payload);
+    s->receivedMask |= (Uint32)1 << hdr.fragmentIndex;
+    if (isLast) s->lastSize = payload;
+
+    Uint32 fullMask = (s->count == 32) ? 0xFFFFFFFFu : (((Uint32)1 << s->count) - 1);
+    if (s->receivedMask != fullMask) return NULL;
+
+    *outLen = (s->count - 1) * FRAGMENT_PAYLOAD_SIZE + s->lastSize;
+    s->used = false;
+    mark_delivered(r, s->messageId);
+    return s->data;
+}
+
+const Uint8 *reassembler_expire(Reassembler *r, Uint32 now, int *outLen) {
+    if (!r || !outLen) return NULL;
+
+    for (int i = 0; i < FRAGMENT_REASSEMBLY_SLOTS; ++i) {
+        ReassemblySlot *s = &r->slots[i];
+        if (!s->used || now - s->firstSeen < FRAGMENT_TIMEOUT_MS) continue;
+
+        s->used = false;
+        int leading = 0;
+        while (leading < s->count && (s->receivedMask & ((Uint32)1 << leading))) leading++;
+        if (leading == 0) continue; // Nothing usable, drop it
+
+        *outLen = leading * FRAGMENT_PAYLOAD_SIZE;
+        mark_delivered(r, s->messageId);
+        return s->data;
+    }
+    return NULL;
+}
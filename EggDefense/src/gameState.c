@@ -3,16 +3,26 @@
 #include "engine.h"
 #include "money_adt.h" // *** VIKTIGT: Inkludera den nya headerfilen ***
 
-// Initialiserar GameState till standardvärden
+// Sätts bara innan simuleringen startar, trådar läser den
+bool gameplayLog = true;
+
+// Initialiserar GameState till standardvärden. GameState äger inget minne,
+// så det finns inget att städa upp efteråt.
 void initialize_game_state(GameState *gameState, GameResources *resources) {
+    game_state_reset(gameState, resources);
+    printf("Game state initialized.\n");
+}
+
+// Ny match i samma GameState: allt nollställs på plats, så en rematch är klar direkt.
+// Skriver inte till resources, renderingstråden äger statiska lagret; ett nytt
+// towerVersion räcker för att det bakas om.
+void game_state_reset(GameState *gameState, GameResources *resources) {
     if (!gameState || !resources) return;
+    Uint32 towerVersion = gameState->towerVersion;
     memset(gameState, 0, sizeof(GameState)); // Nollställer allt
-
+    gameState->towerVersion = towerVersion + 1; // Tornen är borta
     for (int t = 0; t < NUM_TEAMS; ++t) {
-        gameState->team_money[t] = money_manager_create();
-        if (!gameState->team_money[t]) {
-            fprintf(stderr, "ERROR: Failed to create MoneyManager for team %d\n", t);
-        }
+        money_manager_set_balance(&gameState->team_money[t], START_MONEY); // Timern är redan noll
     }
 
     // *** BEHÅLL ALLT DETTA ***
@@ -30,17 +40,35 @@ void initialize_game_state(GameState *gameState, GameResources *resources) {
     gameState->currentWave = 0;
     gameState->inWaveDelay = true;
     gameState->spawnCooldown = 4.0f;
-    gameState->paths = createPaths();
     // *** SLUT PÅ BEHÅLL ***
-
-    printf("Game state initialized (with MoneyManager).\n"); // Uppdaterat meddelande
 }
 
-// *** Lägg till en funktion för att städa upp, om du inte redan har en ***
-// Denna kan anropas från t.ex. cleanup_sdl eller när spelet avslutas.
-void cleanup_game_state(GameState *gameState) {
+// En servertick (flerspelarregler). Samma funktion används av servern och
+// när en replay spolas fram, så båda räknar fram exakt samma tillstånd.
+void game_state_step(GameState *gameState, GameResources *resources, const Audio *audio, float dt) {
     for (int t = 0; t < NUM_TEAMS; ++t) {
-        money_manager_destroy(gameState->team_money[t]);
+        money_manager_update(&gameState->team_money[t], dt);
     }
-     // Lägg till annan städning för GameState här om det behövs
+
+    if (gameState->inWaveDelay) {
+        gameState->spawnCooldown -= dt;
+        if (gameState->spawnCooldown <= 0.0f) {
+            gameState->inWaveDelay = false;
+            if (gameState->currentWave > 0) {
+                play_sound(audio, audio->levelUpSound);
+            }
+            gameState->currentWave++;
+            gameState->spawnTimer = ENEMY_SPAWN_INTERVAL;
+        }
+    } else {
+        gameState->spawnTimer += dt;
+        if (gameState->spawnTimer >= ENEMY_SPAWN_INTERVAL) {
+            gameState->spawnTimer -= ENEMY_SPAWN_INTERVAL;
+            spawn_enemy_pair(gameState, resources);
+        }
+    }
+
+    update_enemies(gameState, resources, dt);
+    update_towers(gameState, audio, dt, resources);
+    update_projectiles(gameState, dt);
 }
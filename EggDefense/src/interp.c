@@ -0,0 +1,63 @@
+// interp.c
+#include <string.h>
+#include <math.h>
+#include "engine.h"
+
+static float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+// Shortest way around, so 350 -> 10 degrees does not spin the long way
+static float lerp_angle(float a, float b, float t) {
+    float d = fmodf(b - a, 360.0f);
+    if (d > 180.0f) d -= 360.0f;
+    else if (d < -180.0f) d += 360.0f;
+    return a + d * t;
+}
+
+// Same index first (usual case), otherwise search
+static const InterpEntity *find(const InterpEntity *list, int count, int index, Uint32 id) {
+    if (index < count && list[index].id == id) return &list[index];
+    for (int i = 0; i < count; ++i) {
+        if (list[i].id == id) return &list[i];
+    }
+    return NULL;
+}
+
+void interp_capture(InterpFrame *frame, const GameState *gameState) {
+    if (!frame || !gameState) return;
+    frame->numEnemies = gameState->numEnemiesActive;
+    for (int i = 0; i < frame->numEnemies; ++i) {
+        const Enemy *e = &gameState->enemies[i];
+        frame->enemies[i] = (InterpEntity){ e->id, e->x, e->y, e->angle };
+    }
+    frame->numProjectiles = gameState->numProjectiles;
+    for (int i = 0; i < frame->numProjectiles; ++i) {
+        const Projectile *p = &gameState->projectiles[i];
+        frame->projectiles[i] = (InterpEntity){ p->id, p->x, p->y, p->angle };
+    }
+}
+
+void interp_apply(const InterpFrame *prev, GameState *renderState, float alpha) {
+    if (!prev || !renderState) return;
+    if (alpha < 0.0f) alpha = 0.0f;
+    if (alpha > 1.0f) alpha = 1.0f;
+
+    // Entities spawned during the last step have no previous transform and
+    // are drawn where they are
+    for (int i = 0; i < renderState->numEnemiesActive; ++i) {
+        Enemy *e = &renderState->enemies[i];
+        const InterpEntity *from = find(prev->enemies, prev->numEnemies, i, e->id);
+        if (!from) continue;
+        e->x = lerp(from->x, e->x, alpha);
+        e->y = lerp(from->y, e->y, alpha);
+        e->angle = lerp_angle(from->angle, e->angle, alpha);
+    }
+    for (int i = 0; i < renderState->numProjectiles; ++i) {
+        Projectile *p = &renderState->projectiles[i];
+        const InterpEntity *from = find(prev->projectiles, prev->numProjectiles, i, p->id);
+        if (!from) continue;
+        p->x = lerp(from->x, p->x, alpha);
+        p->y = lerp(from->y, p->y, alpha);
+    }
+}
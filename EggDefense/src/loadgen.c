@@ -0,0 +1,476 @@
+// loadgen.c
+// Headless load generator: runs many bot clients from one process against a
+// server, speaking the real protocol (READY, heartbeats, PLACE_TOWER), and
+// prints a summary of tick pacing, latency, loss and bandwidth at the end.
+//
+// Usage: loadgen [host] [-p port] [-m matches] [-b bots] [-d seconds]
+//                [-r placements/s per bot] [-s seed]
+// Bots are split MAX_PLAYERS per match; match i is expected on port + i.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_net.h>
+
+#include "defs.h"
+#include "network.h"
+#include "fragment.h"
+#include "snapshot.h"
+#include "netstats.h"
+
+#define LOADGEN_MAX_BOTS 1000        // SDLNet_CheckSockets is select() based
+#define LOADGEN_INTERVAL_BUCKETS 256 // Snapshot interval histogram, 1 ms per bucket
+#define LOADGEN_LATENCY_BUCKETS 256  // Queueing delay histogram, 1 ms per bucket
+
+typedef enum {
+    BOT_CONNECTING,
+    BOT_WAITING,
+    BOT_RUNNING,
+    BOT_GAME_OVER,
+    BOT_REJECTED
+} BotState;
+
+typedef struct {
+    const char *host;
+    Uint16 port;
+    int matches;
+    int bots;
+    int durationSec;
+    float placeRate;    // Tower requests per second per bot
+    Uint32 seed;
+} LoadgenConfig;
+
+typedef struct {
+    UDPsocket socket;
+    UDPpacket *packet;
+    IPaddress server;
+    BotState state;
+    int playerIndex;
+    Reassembler *reassembler;
+    NetStats stats;
+    Uint32 rng;
+
+    Uint32 lastReadySend;
+    Uint32 lastHeartbeatSend;
+    Uint32 nextPlaceTime;
+
+    // Server tick pacing as seen from the snapshot stream
+    Uint32 lastSnapshotAt;
+    Uint32 intervalBuckets[LOADGEN_INTERVAL_BUCKETS];
+    Uint32 intervalCount;
+    Uint64 intervalSum;
+    Uint32 intervalMax;
+
+    // Snapshot transit above the lowest seen (queueing + reassembly delay)
+    bool hasMinTransit;
+    Sint64 minTransit;
+    Uint32 latencyBuckets[LOADGEN_LATENCY_BUCKETS];
+
+    Uint32 snapshots;
+    Uint32 partialSnapshots;
+    Uint32 decodeFailures;
+    Uint32 hashMismatches;      // Decoded snapshots whose checksum did not match
+    Uint32 towersRequested, towersConfirmed, towersRejected;
+} Bot;
+
+static Uint32 bot_random(Bot *bot) {
+    Uint32 x = bot->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bot->rng = x;
+    return x;
+}
+
+static void bot_send(Bot *bot, ClientPacketData *data, Uint32 now) {
+    netstats_stamp(&bot->stats, &data->stamp, now);
+    bot->packet->address = bot->server;
+    bot->packet->len     = sizeof(ClientPacketData);
+    memcpy(bot->packet->data, data, sizeof(ClientPacketData));
+    if (SDLNet_UDP_Send(bot->socket, -1, bot->packet) != 0) {
+        netstats_on_send(&bot->stats, (int)sizeof(ClientPacketData), 1);
+    }
+}
+
+static void schedule_placement(Bot *bot, const LoadgenConfig *cfg, Uint32 now) {
+    if (cfg->placeRate <= 0.0f) {
+        bot->nextPlaceTime = 0;
+        return;
+    }
+    // Average interval 1/rate, spread 0.5x..1.5x so bots do not fire in lockstep
+    float interval = 1000.0f / cfg->placeRate;
+    float spread   = 0.5f + (float)(bot_random(bot) % 1000) / 1000.0f;
+    bot->nextPlaceTime = now + (Uint32)(interval * spread) + 1;
+}
+
+static void request_random_tower(Bot *bot, Uint32 now) {
+    bool leftTeam = (bot->playerIndex == 0 || bot->playerIndex == 2);
+    int half = WINDOW_WIDTH / 2;
+    int x = 50 + (int)(bot_random(bot) % (Uint32)(half - 100));
+    if (!leftTeam) x += half;
+    int y = 50 + (int)(bot_random(bot) % (Uint32)(WINDOW_HEIGHT - 200));
+    ClientPacketData pd = {
+        .command        = CLIENT_CMD_PLACE_TOWER,
+        .playerIndex    = bot->playerIndex,
+        .towerTypeIndex = (int)(bot_random(bot) % 3),
+        .targetX        = x,
+        .targetY        = y
+    };
+    bot_send(bot, &pd, now);
+    bot->towersRequested++;
+}
+
+static void on_snapshot(Bot *bot, const ServerPacketData *hdr, const Uint8 *body, int bodyLen, Uint32 now) {
+    static GameStateSnapshot ss; // Decoded only to exercise the real client path
+    if (!snapshot_decode(body, bodyLen, &ss)) {
+        bot->decodeFailures++;
+        return;
+    }
+    if (ss.stateHash && snapshot_hash(&ss) != ss.stateHash) bot->hashMismatches++;
+    bot->snapshots++;
+
+    if (bot->lastSnapshotAt != 0) {
+        Uint32 interval = now - bot->lastSnapshotAt;
+        int bucket = (interval < LOADGEN_INTERVAL_BUCKETS) ? (int)interval : LOADGEN_INTERVAL_BUCKETS - 1;
+        bot->intervalBuckets[bucket]++;
+        bot->intervalCount++;
+        bot->intervalSum += interval;
+        if (interval > bot->intervalMax) bot->intervalMax = interval;
+    }
+    bot->lastSnapshotAt = now;
+
+    // Clocks are not synchronized, so latency is measured above the best case
+    Sint64 transit = (Sint64)now - (Sint64)hdr->stamp.timestamp;
+    if (!bot->hasMinTransit || transit < bot->minTransit) {
+        bot->minTransit    = transit;
+        bot->hasMinTransit = true;
+    }
+    Sint64 queued = transit - bot->minTransit;
+    int bucket = (queued < LOADGEN_LATENCY_BUCKETS) ? (int)queued : LOADGEN_LATENCY_BUCKETS - 1;
+    bot->latencyBuckets[bucket]++;
+
+    if (hdr->command == SERVER_CMD_GAME_OVER || ss.gameOver) bot->state = BOT_GAME_OVER;
+}
+
+static void on_snapshot_message(Bot *bot, const Uint8 *message, int len, Uint32 now) {
+    if (len < (int)SERVER_PACKET_HEADER_SIZE) return;
+    ServerPacketData hdr;
+    memcpy(&hdr, message, SERVER_PACKET_HEADER_SIZE);
+    netstats_on_stamp(&bot->stats, &hdr.stamp, now);
+    netstats_on_snapshot(&bot->stats, len);
+    on_snapshot(bot, &hdr, message + SERVER_PACKET_HEADER_SIZE, len - (int)SERVER_PACKET_HEADER_SIZE, now);
+}
+
+static void on_datagram(Bot *bot, const Uint8 *data, int len, Uint32 now) {
+    if ((size_t)len < sizeof(ServerCommandType)) return;
+    netstats_on_receive(&bot->stats, len);
+    ServerCommandType command;
+    memcpy(&command, data, sizeof command);
+    if (command == SERVER_CMD_FRAGMENT) {
+        int msgLen = 0;
+        const Uint8 *message = reassembler_accept(bot->reassembler, data, len, now, &msgLen);
+        if (message) on_snapshot_message(bot, message, msgLen, now);
+        return;
+    }
+
+    ServerPacketData sd;
+    memset(&sd, 0, SERVER_PACKET_HEADER_SIZE);
+    memcpy(&sd, data, ((size_t)len < SERVER_PACKET_HEADER_SIZE) ? (size_t)len : SERVER_PACKET_HEADER_SIZE);
+    netstats_on_stamp(&bot->stats, &sd.stamp, now);
+    switch (sd.command) {
+        case SERVER_CMD_ASSIGN_INDEX:
+            if (bot->state == BOT_CONNECTING) {
+                bot->playerIndex = sd.assignedPlayerIndex;
+                bot->state = BOT_WAITING;
+            }
+            break;
+        case SERVER_CMD_GAME_START:
+            if (bot->state == BOT_WAITING) bot->state = BOT_RUNNING;
+            break;
+        case SERVER_CMD_GAME_OVER:
+            bot->state = BOT_GAME_OVER;
+            break;
+        case SERVER_CMD_REJECT_FULL:
+            if (bot->state == BOT_CONNECTING) bot->state = BOT_REJECTED;
+            break;
+        case SERVER_CMD_PLACE_TOWER_CONFIRM:
+            bot->towersConfirmed++;
+            break;
+        case SERVER_CMD_PLACE_TOWER_REJECT:
+            bot->towersRejected++;
+            break;
+        default:
+            break;
+    }
+}
+
+static void bot_update(Bot *bot, const LoadgenConfig *cfg, Uint32 now) {
+    while (SDLNet_UDP_Recv(bot->socket, bot->packet) > 0) {
+        on_datagram(bot, bot->packet->data, bot->packet->len, now);
+    }
+    int len = 0;
+    const Uint8 *partial;
+    while ((partial = reassembler_expire(bot->reassembler, now, &len)) != NULL) {
+        bot->partialSnapshots++;
+        on_snapshot_message(bot, partial, len, now);
+    }
+
+    switch (bot->state) {
+        case BOT_CONNECTING:
+            if (now - bot->lastReadySend > CLIENT_READY_INTERVAL) {
+                ClientPacketData rp = {.command = CLIENT_CMD_READY, .playerIndex = -1};
+                bot_send(bot, &rp, now);
+                bot->lastReadySend = now;
+            }
+            break;
+        case BOT_WAITING:
+        case BOT_RUNNING:
+            if (now - bot->lastHeartbeatSend > CLIENT_HEARTBEAT_INTERVAL) {
+                ClientPacketData hb = {.command = CLIENT_CMD_HEARTBEAT, .playerIndex = bot->playerIndex};
+                bot_send(bot, &hb, now);
+                bot->lastHeartbeatSend = now;
+            }
+            if (bot->state == BOT_RUNNING && bot->nextPlaceTime != 0 &&
+                (Sint32)(now - bot->nextPlaceTime) >= 0) {
+                request_random_tower(bot, now);
+                schedule_placement(bot, cfg, now);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static bool bot_open(Bot *bot, const LoadgenConfig *cfg, int index, Uint32 now) {
+    memset(bot, 0, sizeof *bot);
+    int match = (index / MAX_PLAYERS) % cfg->matches;
+    if (SDLNet_ResolveHost(&bot->server, cfg->host, (Uint16)(cfg->port + match)) == -1) {
+        printf("Bot %d: ResolveHost failed: %s\n", index, SDLNet_GetError());
+        return false;
+    }
+    bot->socket = SDLNet_UDP_Open(0);
+    bot->packet = SDLNet_AllocPacket(PACKET_BUFFER_SIZE);
+    bot->reassembler = reassembler_create();
+    if (!bot->socket || !bot->packet || !bot->reassembler) {
+        printf("Bot %d: failed to open: %s\n", index, SDLNet_GetError());
+        return false;
+    }
+    bot->state         = BOT_CONNECTING;
+    bot->playerIndex   = -1;
+    bot->rng           = cfg->seed * 2654435761u + (Uint32)index + 1;
+    bot->lastReadySend = now - CLIENT_READY_INTERVAL - 1; // Send READY right away
+    netstats_reset(&bot->stats, now);
+    schedule_placement(bot, cfg, now);
+    return true;
+}
+
+static void bot_close(Bot *bot) {
+    if (bot->packet) SDLNet_FreePacket(bot->packet);
+    if (bot->socket) SDLNet_UDP_Close(bot->socket);
+    reassembler_destroy(bot->reassembler);
+    bot->packet = NULL;
+    bot->socket = NULL;
+    bot->reassembler = NULL;
+}
+
+static int histogram_percentile(const Uint32 *buckets, int count, Uint64 total, float fraction) {
+    if (total == 0) return 0;
+    Uint64 target = (Uint64)(fraction * (float)total);
+    Uint64 seen = 0;
+    for (int i = 0; i < count; ++i) {
+        seen += buckets[i];
+        if (seen > target) return i;
+    }
+    return count - 1;
+}
+
+static void print_report(const Bot *bots, int numBots, const LoadgenConfig *cfg, Uint32 elapsedMs) {
+    static Uint32 intervals[LOADGEN_INTERVAL_BUCKETS];
+    static Uint32 latency[LOADGEN_LATENCY_BUCKETS];
+    static Uint32 snapshotSizes[NETSTATS_SIZE_BUCKETS];
+    memset(intervals, 0, sizeof intervals);
+    memset(latency, 0, sizeof latency);
+    memset(snapshotSizes, 0, sizeof snapshotSizes);
+
+    int states[BOT_REJECTED + 1] = {0};
+    Uint64 intervalCount = 0, intervalSum = 0, latencyCount = 0, snapshotCount = 0;
+    Uint32 intervalMax = 0, partial = 0, decodeFailures = 0, hashMismatches = 0;
+    Uint32 towersRequested = 0, towersConfirmed = 0, towersRejected = 0;
+    Uint64 expected = 0, lost = 0, bytesIn = 0, bytesOut = 0;
+    float rttSum = 0.0f, rttMax = 0.0f, jitterSum = 0.0f;
+    int rttBots = 0;
+
+    for (int b = 0; b < numBots; ++b) {
+        const Bot *bot = &bots[b];
+        states[bot->state]++;
+        for (int i = 0; i < LOADGEN_INTERVAL_BUCKETS; ++i) intervals[i] += bot->intervalBuckets[i];
+        for (int i = 0; i < LOADGEN_LATENCY_BUCKETS; ++i) {
+            latency[i] += bot->latencyBuckets[i];
+            latencyCount += bot->latencyBuckets[i];
+        }
+        for (int i = 0; i < NETSTATS_SIZE_BUCKETS; ++i) snapshotSizes[i] += bot->stats.snapshotSizeBuckets[i];
+        intervalCount += bot->intervalCount;
+        intervalSum   += bot->intervalSum;
+        if (bot->intervalMax > intervalMax) intervalMax = bot->intervalMax;
+        snapshotCount  += bot->snapshots;
+        partial        += bot->partialSnapshots;
+        decodeFailures += bot->decodeFailures;
+        hashMismatches += bot->hashMismatches;
+        towersRequested += bot->towersRequested;
+        towersConfirmed += bot->towersConfirmed;
+        towersRejected  += bot->towersRejected;
+        expected += bot->stats.packetsExpected;
+        lost     += (Uint64)(netstats_loss_percent(&bot->stats) * (float)bot->stats.packetsExpected / 100.0f + 0.5f);
+        bytesIn  += bot->stats.bytesIn;
+        bytesOut += bot->stats.bytesOut;
+        if (bot->stats.hasRtt) {
+            rttSum += bot->stats.rttMs;
+            if (bot->stats.rttMs > rttMax) rttMax = bot->stats.rttMs;
+            rttBots++;
+        }
+        jitterSum += bot->stats.jitterMs;
+    }
+
+    float seconds = (float)elapsedMs / 1000.0f;
+    float tickMs  = 1000.0f / (float)GAME_TICK_RATE;
+    NetStats merged = {0};
+    memcpy(merged.snapshotSizeBuckets, snapshotSizes, sizeof snapshotSizes);
+    merged.snapshotCount = (Uint32)snapshotCount;
+
+    printf("\n===== loadgen report =====\n");
+    printf("Target:      %s:%u, %d match(es), %d bots, %.1f s, %.2f placements/s/bot, seed %u\n",
+           cfg->host, (unsigned)cfg->port, cfg->matches, numBots, seconds, cfg->placeRate, (unsigned)cfg->seed);
+    printf("Bots:        %d running, %d waiting, %d connecting, %d game over, %d rejected\n",
+           states[BOT_RUNNING], states[BOT_WAITING], states[BOT_CONNECTING],
+           states[BOT_GAME_OVER], states[BOT_REJECTED]);
+    printf("Snapshots:   %llu (%.0f/s), %u completed from partial fragments, %u decode failures, %u checksum mismatches\n",
+           (unsigned long long)snapshotCount, seconds > 0 ? (float)snapshotCount / seconds : 0.0f,
+           (unsigned)partial, (unsigned)decodeFailures, (unsigned)hashMismatches);
+    printf("Tick lag:    interval mean %.2f ms (nominal %.2f), p50 %d, p95 %d, p99 %d, max %u ms\n",
+           intervalCount ? (double)intervalSum / (double)intervalCount : 0.0, tickMs,
+           histogram_percentile(intervals, LOADGEN_INTERVAL_BUCKETS, intervalCount, 0.50f),
+           histogram_percentile(intervals, LOADGEN_INTERVAL_BUCKETS, intervalCount, 0.95f),
+           histogram_percentile(intervals, LOADGEN_INTERVAL_BUCKETS, intervalCount, 0.99f),
+           (unsigned)intervalMax);
+    printf("Latency:     RTT mean %.1f ms, max %.1f ms; snapshot delay above best p50 %d, p95 %d, p99 %d ms\n",
+           rttBots ? rttSum / (float)rttBots : 0.0f, rttMax,
+           histogram_percentile(latency, LOADGEN_LATENCY_BUCKETS, latencyCount, 0.50f),
+           histogram_percentile(latency, LOADGEN_LATENCY_BUCKETS, latencyCount, 0.95f),
+           histogram_percentile(latency, LOADGEN_LATENCY_BUCKETS, latencyCount, 0.99f));
+    printf("Loss:        %.2f%% of %llu server messages, jitter mean %.2f ms\n",
+           expected ? 100.0 * (double)lost / (double)expected : 0.0, (unsigned long long)expected,
+           numBots ? jitterSum / (float)numBots : 0.0f);
+    printf("Snapshot size: p50 %d B, p95 %d B\n",
+           netstats_snapshot_percentile(&merged, 0.5f), netstats_snapshot_percentile(&merged, 0.95f));
+    printf("Bandwidth:   in %.1f KB/s, out %.1f KB/s (all bots)\n",
+           seconds > 0 ? (float)bytesIn / 1024.0f / seconds : 0.0f,
+           seconds > 0 ? (float)bytesOut / 1024.0f / seconds : 0.0f);
+    printf("Towers:      %u requested, %u confirmed, %u rejected\n",
+           (unsigned)towersRequested, (unsigned)towersConfirmed, (unsigned)towersRejected);
+}
+
+static bool parse_args(int argc, char *argv[], LoadgenConfig *cfg) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if      (strcmp(arg, "-p") == 0 && hasValue) cfg->port        = (Uint16)atoi(argv[++i]);
+        else if (strcmp(arg, "-m") == 0 && hasValue) cfg->matches     = atoi(argv[++i]);
+        else if (strcmp(arg, "-b") == 0 && hasValue) cfg->bots        = atoi(argv[++i]);
+        else if (strcmp(arg, "-d") == 0 && hasValue) cfg->durationSec = atoi(argv[++i]);
+        else if (strcmp(arg, "-r") == 0 && hasValue) cfg->placeRate   = (float)atof(argv[++i]);
+        else if (strcmp(arg, "-s") == 0 && hasValue) cfg->seed        = (Uint32)strtoul(argv[++i], NULL, 10);
+        else if (arg[0] != '-') cfg->host = arg;
+        else return false;
+    }
+    if (cfg->matches < 1) cfg->matches = 1;
+    if (cfg->bots < 1 || cfg->bots > LOADGEN_MAX_BOTS) {
+        printf("Bot count must be 1..%d\n", LOADGEN_MAX_BOTS);
+        return false;
+    }
+    return cfg->durationSec > 0;
+}
+
+int main(int argc, char *argv[]) {
+    LoadgenConfig cfg = {
+        .host        = "127.0.0.1",
+        .port        = SERVER_PORT,
+        .matches     = 1,
+        .bots        = MAX_PLAYERS,
+        .durationSec = 30,
+        .placeRate   = 0.5f,
+        .seed        = 1
+    };
+    if (!parse_args(argc, argv, &cfg)) {
+        printf("Usage: %s [host] [-p port] [-m matches] [-b bots] [-d seconds] [-r placements/s] [-s seed]\n", argv[0]);
+        return 1;
+    }
+
+    if (SDL_Init(SDL_INIT_TIMER) != 0) {
+        printf("SDL_Init Error: %s\n", SDL_GetError());
+        return 1;
+    }
+    if (SDLNet_Init() != 0) {
+        printf("SDLNet_Init Error: %s\n", SDLNet_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    Bot *bots = calloc((size_t)cfg.bots, sizeof(Bot));
+    SDLNet_SocketSet set = SDLNet_AllocSocketSet(cfg.bots);
+    if (!bots || !set) {
+        printf("Failed to allocate %d bots\n", cfg.bots);
+        free(bots);
+        SDLNet_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    Uint32 start = SDL_GetTicks();
+    int opened = 0;
+    for (; opened < cfg.bots; ++opened) {
+        if (!bot_open(&bots[opened], &cfg, opened, start)) {
+            bot_close(&bots[opened]);
+            break;
+        }
+        SDLNet_UDP_AddSocket(set, bots[opened].socket);
+    }
+    printf("loadgen: %d bots against %s:%u (%d match(es)) for %d s\n",
+           opened, cfg.host, (unsigned)cfg.port, cfg.matches, cfg.durationSec);
+
+    Uint32 end = start + (Uint32)cfg.durationSec * 1000u;
+    Uint32 lastProgress = start;
+    Uint32 now = start;
+    while (opened > 0 && (Sint32)(now - end) < 0) {
+        // Sleeps until any bot socket is readable, at most 1 ms so timers stay on time
+        SDLNet_CheckSockets(set, 1);
+        now = SDL_GetTicks();
+        for (int b = 0; b < opened; ++b) {
+            bot_update(&bots[b], &cfg, now);
+        }
+
+        if (now - lastProgress >= 1000) {
+            lastProgress = now;
+            int running = 0;
+            Uint32 snapshots = 0;
+            for (int b = 0; b < opened; ++b) {
+                if (bots[b].state == BOT_RUNNING) running++;
+                snapshots += bots[b].snapshots;
+            }
+            printf("t=%us running %d/%d snapshots %u\n",
+                   (unsigned)((now - start) / 1000), running, opened, (unsigned)snapshots);
+        }
+    }
+
+    print_report(bots, opened, &cfg, now - start);
+
+    for (int b = 0; b < opened; ++b) {
+        SDLNet_UDP_DelSocket(set, bots[b].socket);
+        bot_close(&bots[b]);
+    }
+    SDLNet_FreeSocketSet(set);
+    free(bots);
+    SDLNet_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,125 @@
+// locallink.c
+#include <string.h>
+#include <SDL2/SDL.h>
+#include "locallink.h"
+
+// Single-producer/single-consumer ring of small fixed-size messages
+typedef struct {
+    Uint8 data[LOCAL_LINK_RING_SIZE][LOCAL_LINK_SLOT_SIZE];
+    int len[LOCAL_LINK_RING_SIZE];
+    SDL_atomic_t head; // Next slot to write (producer only)
+    SDL_atomic_t tail; // Next slot to read (consumer only)
+} LocalRing;
+
+#define SNAPSHOT_FRESH 4 // Set in snapshotMiddle when the writer published a new one
+
+// Intern representation (one link per process, the host only runs one server)
+static struct {
+    SDL_atomic_t open;
+    LocalRing toServer;
+    LocalRing toClient;
+
+    // Triple buffer: the writer owns snapshotBack, the reader owns snapshotFront,
+    // snapshotMiddle is exchanged atomically between them
+    GameStateSnapshot snapshots[3];
+    ServerCommandType snapshotCommands[3];
+    int snapshotBack;
+    int snapshotFront;
+    SDL_atomic_t snapshotMiddle;
+} localLink;
+
+static void ring_reset(LocalRing *r) {
+    SDL_AtomicSet(&r->head, 0);
+    SDL_AtomicSet(&r->tail, 0);
+}
+
+static bool ring_push(LocalRing *r, const void *data, int len) {
+    if (!data || len <= 0 || len > LOCAL_LINK_SLOT_SIZE) return false;
+    int head = SDL_AtomicGet(&r->head);
+    int tail = SDL_AtomicGet(&r->tail);
+    if (head - tail >= LOCAL_LINK_RING_SIZE) return false; // Full, drop like UDP would
+
+    int slot = head % LOCAL_LINK_RING_SIZE;
+    memcpy(r->data[slot], data, (size_t)len);
+    r->len[slot] = len;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&r->head, head + 1);
+    return true;
+}
+
+static int ring_pop(LocalRing *r, Uint8 *buf, int cap) {
+    int tail = SDL_AtomicGet(&r->tail);
+    int head = SDL_AtomicGet(&r->head);
+    if (tail == head) return 0;
+    SDL_MemoryBarrierAcquire();
+
+    int slot = tail % LOCAL_LINK_RING_SIZE;
+    int len = r->len[slot] < cap ? r->len[slot] : cap;
+    memcpy(buf, r->data[slot], (size_t)len);
+    SDL_AtomicSet(&r->tail, tail + 1);
+    return len;
+}
+
+void locallink_open(void) {
+    ring_reset(&localLink.toServer);
+    ring_reset(&localLink.toClient);
+    localLink.snapshotBack  = 0;
+    localLink.snapshotFront = 1;
+    SDL_AtomicSet(&localLink.snapshotMiddle, 2);
+    SDL_AtomicSet(&localLink.open, 1);
+}
+
+void locallink_close(void) {
+    SDL_AtomicSet(&localLink.open, 0);
+}
+
+bool locallink_is_open(void) {
+    return SDL_AtomicGet(&localLink.open) != 0;
+}
+
+bool locallink_is_local_address(IPaddress address) {
+    return address.host == LOCAL_LINK_HOST && address.port == LOCAL_LINK_PORT;
+}
+
+bool locallink_client_send(const void *data, int len) {
+    return locallink_is_open() && ring_push(&localLink.toServer, data, len);
+}
+
+int locallink_server_recv(UDPpacket *packet) {
+    if (!packet || !locallink_is_open()) return 0;
+    int len = ring_pop(&localLink.toServer, packet->data, packet->maxlen);
+    if (len <= 0) return 0;
+    packet->len = len;
+    packet->address.host = LOCAL_LINK_HOST;
+    packet->address.port = LOCAL_LINK_PORT;
+    return 1;
+}
+
+bool locallink_server_send(const void *data, int len) {
+    return locallink_is_open() && ring_push(&localLink.toClient, data, len);
+}
+
+int locallink_client_recv(Uint8 *buf, int cap) {
+    if (!buf || !locallink_is_open()) return 0;
+    return ring_pop(&localLink.toClient, buf, cap);
+}
+
+GameStateSnapshot *locallink_snapshot_begin(void) {
+    return &localLink.snapshots[localLink.snapshotBack];
+}
+
+void locallink_snapshot_publish(ServerCommandType command) {
+    localLink.snapshotCommands[localLink.snapshotBack] = command;
+    // SDL_AtomicSet is a full-barrier exchange, so the filled buffer is visible
+    // before the reader can pick it up
+    int old = SDL_AtomicSet(&localLink.snapshotMiddle, localLink.snapshotBack | SNAPSHOT_FRESH);
+    localLink.snapshotBack = old & 3;
+}
+
+const GameStateSnapshot *locallink_snapshot_take(ServerCommandType *command) {
+    if (!(SDL_AtomicGet(&localLink.snapshotMiddle) & SNAPSHOT_FRESH)) return NULL;
+    int old = SDL_AtomicSet(&localLink.snapshotMiddle, localLink.snapshotFront);
+    localLink.snapshotFront = old & 3;
+    if (command) *command = localLink.snapshotCommands[localLink.snapshotFront];
+    return &localLink.snapshots[localLink.snapshotFront];
+}
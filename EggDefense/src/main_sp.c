@@ -1,106 +1,199 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <SDL2/SDL.h>
 
 #include "engine.h"
 #include "paths.h"
+#include "renderqueue.h"
 
-void run_singleplayer() {
-    SDL_Window *window = NULL;
-    SDL_Renderer *renderer = NULL;
-    GameResources resources = {0};
-    Audio audio = {0};
-    GameState gameState = {0};
-    float birdRotations[MAX_PLACED_BIRDS] = {0};
+#define SIM_DT (1.0f / SINGLEPLAYER_SIM_RATE)
 
-    if (!initialize_sdl(&window, &renderer, "Tower Defense - Singleplayer")) return;
-    if (!initialize_subsystems()) { cleanup_sdl(window, renderer); return; }
-    if (!load_resources(renderer, &resources, &audio)) {
-        cleanup_resources(&resources, &audio); cleanup_subsystems(); cleanup_sdl(window, renderer); return;
+// One fixed simulation step
+static void simulate_step(GameState *gs, Audio *audio, GameResources *resources, float dt) {
+    for (int t = 0; t < NUM_TEAMS; ++t) {
+        money_manager_update(&gs->team_money[t], dt);
     }
-    initialize_game_state(&gameState, &resources);
+    update_enemies(gs, resources, dt);
+    update_towers(gs, audio, dt, resources);
+    update_projectiles(gs, dt);
+    if (gs->inWaveDelay) {
+        gs->spawnCooldown -= dt;
+        if (gs->spawnCooldown <= 0.0f) { // start next wave when wave cool down timer is finished
+            gs->inWaveDelay = false;
+            if (gs->currentWave>0)
+            {
+                play_sound(audio, audio->levelUpSound); //play level up sound effect at new wave, except first
+                gs->spawnTimer = ENEMY_SPAWN_INTERVAL; //spawn new enemies instantly when new wave starts, exept first
+            }
+            
+            gs->currentWave++;
+        }
+    }
+    else {
+        gs->spawnTimer += dt;
+        if (gs->spawnTimer >= ENEMY_SPAWN_INTERVAL) {
+            gs->spawnTimer = 0;
+            spawn_enemy_pair(gs, resources);
+        }
+    }
+}
 
-    bool quit = false;
+// State shared with the logic thread (large, keep off the stack)
+typedef struct {
+    GameState gameState;
+    InterpFrame previous;       // Transforms before the latest step
+    float birdRotations[MAX_PLACED_BIRDS];
+    Audio *audio;
+    GameResources *resources;
+    RenderQueue *queue;
+    bool checkDeterminism;      // EGG_DETERMINISM_CHECK: every step is run twice and compared
+    GameState shadow;           // State before the step, stepped again for the check
+    Uint32 steps;               // Steps since the match started
+} SingleplayerLogic;
+
+// Steps the copy taken before the step once more (silently) and compares
+// it with the real result. Any difference means the simulation depends on
+// something besides the state and dt. Reports the first differing field
+// once and then stops checking.
+static void check_determinism(SingleplayerLogic *sp) {
+    Audio silent = {0};
+    simulate_step(&sp->shadow, &silent, sp->resources, SIM_DT);
+    Uint32 expected = state_hash(&sp->gameState);
+    if (state_hash(&sp->shadow) == expected) return;
+    char field[160];
+    state_hash_diff(&sp->gameState, &sp->shadow, field, sizeof field);
+    printf("Determinism check: step %u diverged (hash %08x vs %08x), first difference %s\n",
+           (unsigned)sp->steps, (unsigned)expected, (unsigned)state_hash(&sp->shadow), field);
+    sp->checkDeterminism = false;
+}
+
+static void publish_frame(SingleplayerLogic *sp, GameStatus status, Uint64 lastStep, const char *gameOverMsg, bool quit) {
+    RenderFrame *frame = render_queue_begin(sp->queue);
+    frame->quit = quit;
+    frame->view = (status == GAME_STATE_MAIN_MENU) ? RENDER_VIEW_MENU
+                : (status == GAME_STATE_PLAYING) ? RENDER_VIEW_GAME : RENDER_VIEW_GAME_OVER;
+    if (status != GAME_STATE_MAIN_MENU) {
+        frame->state = sp->gameState; // Pointer-free, a plain copy
+        memcpy(frame->birdRotations, sp->birdRotations, sizeof(frame->birdRotations));
+    }
+    // The render thread interpolates from the previous step up to this one
+    frame->previous = sp->previous;
+    frame->stepCounter = (status == GAME_STATE_PLAYING) ? lastStep : 0;
+    frame->placingBird = sp->gameState.placingBird;
+    frame->selectedOption = sp->gameState.selectedOption;
+    frame->playerIndex = -1;
+    frame->statusText[0] = '\0';
+    frame->netStatsLine[0] = '\0';
+    snprintf(frame->overlayText, sizeof(frame->overlayText), "%s", gameOverMsg);
+    frame->canRematch = true;
+    render_queue_publish(sp->queue);
+}
+
+// Input and fixed-rate simulation, beside the render (main) thread
+static int singleplayer_logic_thread(void *data) {
+    SingleplayerLogic *sp = data;
+    GameState *gs = &sp->gameState;
     GameStatus currentStatus = GAME_STATE_MAIN_MENU;
-    Uint32 last_time = SDL_GetTicks();
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 stepTicks = frequency / SINGLEPLAYER_SIM_RATE;
+    Uint64 maxBehind = (Uint64)(SINGLEPLAYER_MAX_FRAME_TIME * (double)frequency);
+    Uint64 lastStep = 0;        // Performance counter the latest step belongs to
+    char gameOverMsg[128] = "";
+    bool quit = false;
+    bool changed = true;        // Publish a frame this iteration
 
     while (!quit) {
-        float dt = get_delta_time(&last_time);
-        InputContext inputCtx = (currentStatus == GAME_STATE_MAIN_MENU) ? INPUT_CONTEXT_MAIN_MENU : INPUT_CONTEXT_SINGLEPLAYER;
-        handle_input(inputCtx, &gameState, &resources, NULL, &quit);
+        SDL_Event event;
+        while (render_queue_pop_input(sp->queue, &event)) {
+            InputContext inputCtx = (currentStatus == GAME_STATE_MAIN_MENU) ? INPUT_CONTEXT_MAIN_MENU : INPUT_CONTEXT_SINGLEPLAYER;
+            handle_input(inputCtx, gs, sp->resources, NULL, &event, &quit);
+            if (currentStatus == GAME_STATE_MAIN_MENU && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE) {
+                currentStatus = GAME_STATE_PLAYING;
+                play_music(sp->audio->bgm);
+                lastStep = SDL_GetPerformanceCounter();
+                interp_capture(&sp->previous, gs);
+            }
+            else if (currentStatus == GAME_STATE_GAME_OVER && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE) {
+                // Rematch: same allocations, playing again from the next frame
+                game_state_reset(gs, sp->resources);
+                sp->steps = 0;
+                memset(sp->birdRotations, 0, sizeof(sp->birdRotations));
+                gameOverMsg[0] = '\0';
+                currentStatus = GAME_STATE_PLAYING;
+                play_music(sp->audio->bgm);
+                lastStep = SDL_GetPerformanceCounter();
+                interp_capture(&sp->previous, gs);
+            }
+            changed = true;
+        }
         if (quit) break;
 
-        switch (currentStatus) {
-            case GAME_STATE_MAIN_MENU:
-                const Uint8* keyboardState = SDL_GetKeyboardState(NULL);
-                if (keyboardState[SDL_SCANCODE_SPACE]) {
-                    currentStatus = GAME_STATE_PLAYING;
-                     play_music(audio.bgm);
-                    last_time = SDL_GetTicks();
-                }
-                render_main_menu(renderer, &resources, MODE_SINGLEPLAYER);
-                break;
+        if (currentStatus == GAME_STATE_PLAYING) {
+            // Fixed-rate simulation, as many steps as real time calls for
+            Uint64 now = SDL_GetPerformanceCounter();
+            if (now - lastStep > maxBehind) lastStep = now - maxBehind; // Do not spiral after a stall
+            while (now - lastStep >= stepTicks && !gs->gameOver) {
+                interp_capture(&sp->previous, gs);
+                if (sp->checkDeterminism) sp->shadow = *gs;
+                simulate_step(gs, sp->audio, sp->resources, SIM_DT);
+                sp->steps++;
+                if (sp->checkDeterminism) check_determinism(sp);
+                lastStep += stepTicks;
+                changed = true;
+            }
+            if (changed) calculate_tower_rotations(gs, sp->birdRotations);
+            if (gs->gameOver) {
+                currentStatus = GAME_STATE_GAME_OVER;
+                stop_music();
+                if (gs->leftPlayerHP <= 0 && gs->rightPlayerHP <= 0) { snprintf(gameOverMsg, sizeof(gameOverMsg), "GAME OVER - DRAW!"); }
+                else if (gs->leftPlayerHP <= 0) { snprintf(gameOverMsg, sizeof(gameOverMsg), "GAME OVER - Player 1 Loses!"); }
+                else if (gs->rightPlayerHP <= 0) { snprintf(gameOverMsg, sizeof(gameOverMsg), "GAME OVER - Player 2 Loses!"); }
+                else { snprintf(gameOverMsg, sizeof(gameOverMsg), "GAME OVER"); }
+            }
+        }
 
-            case GAME_STATE_PLAYING:
-                //updating game
-                for (int t = 0; t < NUM_TEAMS; ++t) {
-                    money_manager_update(gameState.team_money[t], dt);
-                }
-                update_enemies(&gameState, dt);
-                update_towers(&gameState, &audio, dt, &resources);
-                update_projectiles(&gameState, dt);
-                if (gameState.inWaveDelay) {
-                    gameState.spawnCooldown -= dt;
-                    if (gameState.spawnCooldown <= 0.0f) { // start next wave when wave cool down timer is finished
-                        gameState.inWaveDelay = false;
-                        if (gameState.currentWave>0)
-                        {
-                            play_sound(&audio, audio.levelUpSound); //play level up sound effect at new wave, except first
-                            gameState.spawnTimer = ENEMY_SPAWN_INTERVAL; //spawn new enemies instantly when new wave starts, exept first
-                        }
-                        
-                        gameState.currentWave++;
-                    }
-                }
-                else {
-                    gameState.spawnTimer += dt;
-                    if (gameState.spawnTimer >= ENEMY_SPAWN_INTERVAL) {
-                        gameState.spawnTimer = 0;
-                        spawn_enemy_pair(&gameState, &resources);
-                    }
-                }
-                
-                //rendering new frame
-                calculate_tower_rotations(&gameState, birdRotations);
-                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-                SDL_RenderClear(renderer);
-                render_game(renderer, &gameState, &resources, birdRotations, gameState.placingBird, gameState.selectedOption, -1);
-                if (gameState.gameOver) {
-                    currentStatus = GAME_STATE_GAME_OVER;
-                    stop_music();
-                }
-                break;
+        if (changed) publish_frame(sp, currentStatus, lastStep, gameOverMsg, false);
+        changed = false;
+        SDL_Delay(1);
+    }
+    publish_frame(sp, currentStatus, lastStep, gameOverMsg, true);
+    return 0;
+}
 
-            case GAME_STATE_GAME_OVER:
-                {
-                 char gameOverMsg[128];
-                 if (gameState.leftPlayerHP <= 0 && gameState.rightPlayerHP <= 0) { snprintf(gameOverMsg, sizeof(gameOverMsg), "GAME OVER - DRAW!"); }
-                 else if (gameState.leftPlayerHP <= 0) { snprintf(gameOverMsg, sizeof(gameOverMsg), "GAME OVER - Player 1 Loses!"); }
-                 else if (gameState.rightPlayerHP <= 0) { snprintf(gameOverMsg, sizeof(gameOverMsg), "GAME OVER - Player 2 Loses!"); }
-                 else { snprintf(gameOverMsg, sizeof(gameOverMsg), "GAME OVER"); }
-                 render_game_over(renderer, &resources, gameOverMsg);
-                }
-                break;
-        }
+// Window and resources come from the app, nothing is loaded or freed here
+void run_singleplayer(AppContext *app) {
+    static SingleplayerLogic logic;
+
+    SDL_SetWindowTitle(app->window, "Tower Defense - Singleplayer");
+    memset(&logic, 0, sizeof(logic));
+    initialize_game_state(&logic.gameState, &app->resources);
+    logic.audio = &app->audio;
+    logic.resources = &app->resources;
+    logic.queue = render_queue_create();
+    logic.checkDeterminism = getenv("EGG_DETERMINISM_CHECK") != NULL;
+    if (logic.checkDeterminism) printf("Determinism check on: every step is simulated twice.\n");
 
-        if (currentStatus != GAME_STATE_MAIN_MENU) {
-            SDL_RenderPresent(renderer);
+    // SDL wants the window, its events and the renderer on the thread that
+    // created them, so this thread renders and the simulation runs beside it
+    SDL_Thread *logicThread = logic.queue ? SDL_CreateThread(singleplayer_logic_thread, "SingleplayerLogic", &logic) : NULL;
+    if (!logicThread) {
+        printf("Failed to start singleplayer logic thread: %s\n", SDL_GetError());
+    } else {
+        while (true) {
+            if (render_queue_pump_events(logic.queue, &app->resources)) app->quit = true;
+            RenderFrame *frame = render_queue_acquire(logic.queue);
+            if (!frame) { SDL_Delay(1); continue; }
+            if (frame->quit) break;
+            // Presenting blocks on vsync here, not in the simulation
+            render_frame(app->renderer, &app->resources, frame, MODE_SINGLEPLAYER);
         }
+        SDL_WaitThread(logicThread, NULL);
     }
 
     printf("Shutting down singleplayer...\n");
-    cleanup_resources(&resources, &audio);
-    cleanup_subsystems();
-    cleanup_sdl(window, renderer);
+    render_queue_destroy(logic.queue);
+    stop_music();
     printf("Singleplayer shutdown complete.\n");
 }
@@ -0,0 +1,157 @@
+// netcond.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "netcond.h"
+
+typedef struct {
+    bool used;
+    Uint32 dueTime;
+    Uint32 order;           // Push order, keeps equal due times FIFO
+    IPaddress address;
+    int len;
+    Uint8 data[PACKET_BUFFER_SIZE];
+} DelayedDatagram;
+
+// Intern representation
+struct NetConditioner {
+    NetConditionerConfig cfg;
+    Uint32 rng;
+    Uint32 nextOrder;
+    DelayedDatagram queue[NETCOND_QUEUE_SIZE];
+    Uint8 out[PACKET_BUFFER_SIZE];
+
+    // Counters for the summary on destroy
+    Uint32 pushed, dropped, duplicated, reordered, overflowed;
+};
+
+// xorshift32, so runs do not depend on the platform's rand()
+static Uint32 next_random(NetConditioner *nc) {
+    Uint32 x = nc->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    nc->rng = x;
+    return x;
+}
+
+static bool roll_percent(NetConditioner *nc, float percent) {
+    if (percent <= 0.0f) return false;
+    return (float)(next_random(nc) % 10000) < percent * 100.0f;
+}
+
+bool netcond_config_from_env(NetConditionerConfig *cfg) {
+    const char *spec = getenv("EGG_NETCOND");
+    if (!cfg || !spec || !*spec) return false;
+    memset(cfg, 0, sizeof *cfg);
+    cfg->seed = 1;
+
+    char buf[256];
+    snprintf(buf, sizeof buf, "%s", spec);
+    for (char *item = buf; item && *item; ) {
+        char *next = strchr(item, ',');
+        if (next) *next++ = '\0';
+        char key[32];
+        float value;
+        if (sscanf(item, "%31[^=]=%f", key, &value) != 2 || value < 0.0f) {
+            printf("Warn: EGG_NETCOND: ignoring '%s'\n", item);
+        } else if (strcmp(key, "delay") == 0)   cfg->delayMs          = (Uint32)value;
+        else if (strcmp(key, "jitter") == 0)    cfg->jitterMs         = (Uint32)value;
+        else if (strcmp(key, "loss") == 0)      cfg->lossPercent      = value;
+        else if (strcmp(key, "dup") == 0)       cfg->duplicatePercent = value;
+        else if (strcmp(key, "reorder") == 0)   cfg->reorderPercent   = value;
+        else if (strcmp(key, "seed") == 0)      cfg->seed             = (Uint32)value;
+        else printf("Warn: EGG_NETCOND: unknown key '%s'\n", key);
+        item = next;
+    }
+    return true;
+}
+
+NetConditioner *netcond_create(const NetConditionerConfig *cfg) {
+    if (!cfg) return NULL;
+    NetConditioner *nc = calloc(1, sizeof *nc);
+    if (!nc) {
+        perror("Failed to allocate network conditioner");
+        return NULL;
+    }
+    nc->cfg = *cfg;
+    nc->rng = cfg->seed ? cfg->seed : 1; // xorshift must not start at 0
+    return nc;
+}
+
+void netcond_destroy(NetConditioner *nc) {
+    if (!nc) return;
+    printf("Netcond: %u datagrams, %u dropped, %u duplicated, %u reordered, %u lost to full queue\n",
+           (unsigned)nc->pushed, (unsigned)nc->dropped, (unsigned)nc->duplicated,
+           (unsigned)nc->reordered, (unsigned)nc->overflowed);
+    free(nc);
+}
+
+bool netcond_create_pair(const NetConditionerConfig *cfg, NetConditioner **out, NetConditioner **in) {
+    if (!cfg || !out || !in) return false;
+    NetConditionerConfig inCfg = *cfg;
+    inCfg.seed = cfg->seed * 2654435761u + 1;
+    *out = netcond_create(cfg);
+    *in  = netcond_create(&inCfg);
+    if (!*out || !*in) {
+        netcond_destroy(*out);
+        netcond_destroy(*in);
+        *out = *in = NULL;
+        return false;
+    }
+    return true;
+}
+
+static void enqueue(NetConditioner *nc, IPaddress address, const void *data, int len, Uint32 now) {
+    Uint32 delay = nc->cfg.delayMs;
+    if (nc->cfg.jitterMs > 0) delay += next_random(nc) % (nc->cfg.jitterMs + 1);
+    if (roll_percent(nc, nc->cfg.reorderPercent)) {
+        delay += NETCOND_REORDER_HOLD_MS;
+        nc->reordered++;
+    }
+    for (int i = 0; i < NETCOND_QUEUE_SIZE; ++i) {
+        DelayedDatagram *d = &nc->queue[i];
+        if (d->used) continue;
+        d->used    = true;
+        d->dueTime = now + delay;
+        d->order   = nc->nextOrder++;
+        d->address = address;
+        d->len     = len;
+        memcpy(d->data, data, (size_t)len);
+        return;
+    }
+    nc->overflowed++;
+}
+
+void netcond_push(NetConditioner *nc, IPaddress address, const void *data, int len, Uint32 now) {
+    if (!nc || !data || len <= 0 || len > PACKET_BUFFER_SIZE) return;
+    nc->pushed++;
+    if (roll_percent(nc, nc->cfg.lossPercent)) {
+        nc->dropped++;
+        return;
+    }
+    enqueue(nc, address, data, len, now);
+    if (roll_percent(nc, nc->cfg.duplicatePercent)) {
+        nc->duplicated++;
+        enqueue(nc, address, data, len, now);
+    }
+}
+
+const Uint8 *netcond_pop(NetConditioner *nc, Uint32 now, IPaddress *address, int *len) {
+    if (!nc) return NULL;
+    DelayedDatagram *best = NULL;
+    for (int i = 0; i < NETCOND_QUEUE_SIZE; ++i) {
+        DelayedDatagram *d = &nc->queue[i];
+        if (!d->used || (Sint32)(now - d->dueTime) < 0) continue;
+        if (!best || (Sint32)(d->dueTime - best->dueTime) < 0 ||
+            (d->dueTime == best->dueTime && (Sint32)(d->order - best->order) < 0)) {
+            best = d;
+        }
+    }
+    if (!best) return NULL;
+    memcpy(nc->out, best->data, (size_t)best->len);
+    if (address) *address = best->address;
+    if (len) *len = best->len;
+    best->used = false;
+    return nc->out;
+}
@@ -0,0 +1,183 @@
+// netstats.c
+#include <string.h>
+#include "netstats.h"
+
+void netstats_reset(NetStats *s, Uint32 now) {
+    if (!s) return;
+    memset(s, 0, sizeof *s);
+    s->windowStart = now;
+}
+
+void netstats_on_send(NetStats *s, int bytes, int packets) {
+    if (!s || bytes <= 0) return;
+    s->bytesOut         += (Uint64)bytes;
+    s->packetsOut       += (Uint64)packets;
+    s->windowBytesOut   += (Uint64)bytes;
+    s->windowPacketsOut += (Uint64)packets;
+}
+
+void netstats_on_receive(NetStats *s, int bytes) {
+    if (!s || bytes <= 0) return;
+    s->bytesIn         += (Uint64)bytes;
+    s->packetsIn++;
+    s->windowBytesIn   += (Uint64)bytes;
+    s->windowPacketsIn++;
+}
+
+static void on_sequence(NetStats *s, Uint32 sequence) {
+    if (!s->hasSequence) {
+        s->hasSequence            = true;
+        s->highestSequence        = sequence;
+        s->packetsExpected        = 1;
+        s->packetsReceivedInOrder = 1;
+        s->recentSeen             = 1;
+        return;
+    }
+    Sint32 gap = (Sint32)(sequence - s->highestSequence);
+    if (gap <= 0) {
+        // Older than what we have seen. Only a packet that fills a gap is
+        // late; a sequence we already have is a duplicate (netcond dup=) and
+        // must not offset real losses. Beyond the window it stays lost.
+        Uint32 age = (Uint32)-gap;
+        if (age >= 64) return;
+        Uint64 bit = (Uint64)1 << age;
+        if (s->recentSeen & bit) {
+            s->packetsDuplicate++;
+        } else {
+            s->recentSeen |= bit;
+            s->packetsLate++;
+        }
+        return;
+    }
+    s->packetsExpected += (Uint32)gap;
+    s->packetsReceivedInOrder++;
+    s->highestSequence = sequence;
+    s->recentSeen = (gap < 64 ? s->recentSeen << gap : 0) | 1;
+}
+
+void netstats_on_snapshot(NetStats *s, int bytes) {
+    if (!s || bytes <= 0) return;
+    int bucket = bytes / NETSTATS_SIZE_BUCKET_BYTES;
+    if (bucket >= NETSTATS_SIZE_BUCKETS) bucket = NETSTATS_SIZE_BUCKETS - 1;
+    s->snapshotSizeBuckets[bucket]++;
+    if (s->snapshotCount == 0 || bytes < s->snapshotMin) s->snapshotMin = bytes;
+    if (bytes > s->snapshotMax) s->snapshotMax = bytes;
+    s->snapshotCount++;
+    s->snapshotBytes += (Uint64)bytes;
+}
+
+static void on_timestamps(NetStats *s, Uint32 now, Uint32 remoteTimestamp, Uint32 echoTimestamp, Uint32 echoDelay) {
+    // RTT: our clock now minus our clock when the echoed packet left,
+    // minus the time the peer sat on it
+    if (echoTimestamp != 0 && echoTimestamp != s->lastEchoSeen) {
+        s->lastEchoSeen = echoTimestamp;
+        Sint32 rtt = (Sint32)(now - echoTimestamp - echoDelay);
+        if (rtt < 0) rtt = 0;
+        s->rttLastMs = (float)rtt;
+        if (!s->hasRtt) {
+            s->rttMs  = s->rttLastMs;
+            s->hasRtt = true;
+        } else {
+            s->rttMs += (s->rttLastMs - s->rttMs) * 0.125f; // Same smoothing as TCP's SRTT
+        }
+    }
+
+    // Jitter: change in relative transit time between consecutive packets.
+    // The clocks are not synchronized, but the offset cancels out.
+    if (remoteTimestamp != 0) {
+        Sint64 transit = (Sint64)now - (Sint64)remoteTimestamp;
+        if (s->hasTransit) {
+            Sint64 d = transit - s->lastTransit;
+            if (d < 0) d = -d;
+            s->jitterMs += ((float)d - s->jitterMs) / 16.0f;
+        }
+        s->lastTransit = transit;
+        s->hasTransit  = true;
+    }
+}
+
+void netstats_stamp(NetStats *s, PacketStamp *stamp, Uint32 now) {
+    if (!s || !stamp) return;
+    stamp->sequence      = ++s->nextSequence; // 0 means unstamped
+    stamp->timestamp     = now;
+    stamp->echoTimestamp = s->peerTimestamp;
+    stamp->echoDelay     = s->peerTimestamp ? now - s->peerTimestampAt : 0;
+}
+
+void netstats_on_stamp(NetStats *s, const PacketStamp *stamp, Uint32 now) {
+    if (!s || !stamp || stamp->sequence == 0) return;
+    on_sequence(s, stamp->sequence);
+    on_timestamps(s, now, stamp->timestamp, stamp->echoTimestamp, stamp->echoDelay);
+    s->peerTimestamp   = stamp->timestamp;
+    s->peerTimestampAt = now;
+}
+
+void netstats_update(NetStats *s, Uint32 now) {
+    if (!s) return;
+    Uint32 elapsed = now - s->windowStart;
+    if (elapsed < 1000) return;
+
+    float seconds = (float)elapsed / 1000.0f;
+    s->bytesInPerSec    = (float)s->windowBytesIn / seconds;
+    s->bytesOutPerSec   = (float)s->windowBytesOut / seconds;
+    s->packetsInPerSec  = (float)s->windowPacketsIn / seconds;
+    s->packetsOutPerSec = (float)s->windowPacketsOut / seconds;
+    s->windowBytesIn = s->windowBytesOut = 0;
+    s->windowPacketsIn = s->windowPacketsOut = 0;
+    s->windowStart = now;
+}
+
+float netstats_loss_percent(const NetStats *s) {
+    if (!s || s->packetsExpected == 0) return 0.0f;
+    Uint32 lost = s->packetsExpected - s->packetsReceivedInOrder;
+    // Late packets were counted as lost when the gap opened
+    lost = (lost > s->packetsLate) ? lost - s->packetsLate : 0;
+    return 100.0f * (float)lost / (float)s->packetsExpected;
+}
+
+int netstats_snapshot_percentile(const NetStats *s, float fraction) {
+    if (!s || s->snapshotCount == 0) return 0;
+    Uint32 target = (Uint32)(fraction * (float)s->snapshotCount);
+    Uint32 seen = 0;
+    for (int i = 0; i < NETSTATS_SIZE_BUCKETS; ++i) {
+        seen += s->snapshotSizeBuckets[i];
+        if (seen > target) return (i + 1) * NETSTATS_SIZE_BUCKET_BYTES;
+    }
+    return s->snapshotMax;
+}
+
+void netstats_format(const NetStats *s, char *buf, size_t cap) {
+    if (!s || !buf || cap == 0) return;
+    snprintf(buf, cap,
+             "RTT %.0fms jit %.1fms loss %.1f%% in %.1fKB/s %.0fp/s out %.1fKB/s %.0fp/s snap p50 %dB p95 %dB",
+             s->hasRtt ? s->rttMs : 0.0f,
+             s->jitterMs,
+             netstats_loss_percent(s),
+             s->bytesInPerSec / 1024.0f, s->packetsInPerSec,
+             s->bytesOutPerSec / 1024.0f, s->packetsOutPerSec,
+             netstats_snapshot_percentile(s, 0.5f),
+             netstats_snapshot_percentile(s, 0.95f));
+}
+
+void netstats_write_csv_header(FILE *f) {
+    if (!f) return;
+    fprintf(f, "time_ms,connection,rtt_ms,rtt_last_ms,jitter_ms,loss_pct,late,duplicates,"
+               "bytes_in_per_s,bytes_out_per_s,packets_in_per_s,packets_out_per_s,"
+               "bytes_in,bytes_out,snapshots,snapshot_avg,snapshot_min,snapshot_p50,snapshot_p95,snapshot_max\n");
+}
+
+void netstats_write_csv_row(FILE *f, Uint32 now, const char *connection, const NetStats *s) {
+    if (!f || !s) return;
+    fprintf(f, "%u,%s,%.2f,%.2f,%.2f,%.3f,%u,%u,%.1f,%.1f,%.1f,%.1f,%llu,%llu,%u,%.1f,%d,%d,%d,%d\n",
+            (unsigned)now, connection ? connection : "",
+            s->rttMs, s->rttLastMs, s->jitterMs, netstats_loss_percent(s), (unsigned)s->packetsLate,
+            (unsigned)s->packetsDuplicate,
+            s->bytesInPerSec, s->bytesOutPerSec, s->packetsInPerSec, s->packetsOutPerSec,
+            (unsigned long long)s->bytesIn, (unsigned long long)s->bytesOut,
+            (unsigned)s->snapshotCount,
+            s->snapshotCount ? (double)s->snapshotBytes / s->snapshotCount : 0.0,
+            s->snapshotMin,
+            netstats_snapshot_percentile(s, 0.5f),
+            netstats_snapshot_percentile(s, 0.95f),
+            s->snapshotMax);
+}
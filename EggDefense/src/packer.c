@@ -0,0 +1,147 @@
+// packer.c
+// Builds the asset archive the game maps at startup (see assetpack.h). PNGs
+// are decoded here once, to RGBA32, so the game never decodes them; all
+// other files are stored as-is.
+//
+// Usage: packer <out.pak> <file>...   (make pack)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include "assetpack.h"
+
+static bool has_extension(const char *path, const char *ext) {
+    size_t n = strlen(path), e = strlen(ext);
+    return n >= e && SDL_strcasecmp(path + n - e, ext) == 0;
+}
+
+// Whole file, caller frees
+static Uint8 *read_file(const char *path, Uint32 *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    Uint8 *data = len > 0 ? malloc((size_t)len) : NULL;
+    if (!data || fread(data, 1, (size_t)len, f) != (size_t)len) {
+        printf("Failed to read '%s'\n", path);
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *size = (Uint32)len;
+    return data;
+}
+
+// Decoded RGBA32 pixels with a tight pitch, caller frees
+static Uint8 *decode_image(const char *path, AssetPackEntry *entry) {
+    SDL_Surface *loaded = IMG_Load(path);
+    if (!loaded) {
+        printf("Failed to decode '%s': %s\n", path, IMG_GetError());
+        return NULL;
+    }
+    SDL_Surface *rgba = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!rgba) {
+        printf("Failed to convert '%s': %s\n", path, SDL_GetError());
+        return NULL;
+    }
+    size_t rowBytes = (size_t)rgba->w * 4;
+    Uint8 *pixels = malloc(rowBytes * (size_t)rgba->h);
+    if (pixels) {
+        for (int y = 0; y < rgba->h; ++y) {
+            memcpy(pixels + rowBytes * (size_t)y, (const Uint8 *)rgba->pixels + (size_t)rgba->pitch * (size_t)y, rowBytes);
+        }
+        entry->kind   = ASSET_PACK_RGBA;
+        entry->width  = (Uint32)rgba->w;
+        entry->height = (Uint32)rgba->h;
+        entry->size   = (Uint32)(rowBytes * (size_t)rgba->h);
+    }
+    SDL_FreeSurface(rgba);
+    return pixels;
+}
+
+static bool write_padding(FILE *out, long *pos) {
+    static const Uint8 zeros[ASSET_PACK_ALIGN] = {0};
+    long pad = (ASSET_PACK_ALIGN - *pos % ASSET_PACK_ALIGN) % ASSET_PACK_ALIGN;
+    *pos += pad;
+    return pad == 0 || fwrite(zeros, 1, (size_t)pad, out) == (size_t)pad;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s <out.pak> <file>...\n", argv[0]);
+        return 1;
+    }
+    const char *outPath = argv[1];
+    int numFiles = argc - 2;
+
+    if (SDL_Init(0) != 0 || !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        printf("SDL/IMG init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    AssetPackEntry *entries = calloc((size_t)numFiles, sizeof *entries);
+    Uint8 **blobs = calloc((size_t)numFiles, sizeof *blobs);
+    bool ok = entries && blobs;
+    for (int i = 0; ok && i < numFiles; ++i) {
+        const char *path = argv[i + 2];
+        if (strlen(path) >= ASSET_PACK_NAME_SIZE) {
+            printf("Name too long for the pack: '%s'\n", path);
+            ok = false;
+            break;
+        }
+        snprintf(entries[i].name, sizeof entries[i].name, "%s", path);
+        if (has_extension(path, ".png")) {
+            blobs[i] = decode_image(path, &entries[i]);
+        } else {
+            entries[i].kind = ASSET_PACK_RAW;
+            blobs[i] = read_file(path, &entries[i].size);
+        }
+        ok = blobs[i] != NULL;
+    }
+
+    FILE *out = ok ? fopen(outPath, "wb") : NULL;
+    if (ok && !out) {
+        perror(outPath);
+        ok = false;
+    }
+    if (ok) {
+        // Offsets first, then header, index and blobs in one pass
+        long pos = (long)(sizeof(AssetPackHeader) + (size_t)numFiles * sizeof(AssetPackEntry));
+        for (int i = 0; i < numFiles; ++i) {
+            pos += (ASSET_PACK_ALIGN - pos % ASSET_PACK_ALIGN) % ASSET_PACK_ALIGN;
+            entries[i].offset = (Uint32)pos;
+            pos += (long)entries[i].size;
+        }
+        AssetPackHeader header = { ASSET_PACK_MAGIC, ASSET_PACK_VERSION, (Uint32)numFiles, 0 };
+        ok = fwrite(&header, sizeof header, 1, out) == 1
+          && fwrite(entries, sizeof *entries, (size_t)numFiles, out) == (size_t)numFiles;
+        pos = (long)(sizeof header + (size_t)numFiles * sizeof *entries);
+        for (int i = 0; ok && i < numFiles; ++i) {
+            ok = write_padding(out, &pos)
+              && fwrite(blobs[i], 1, entries[i].size, out) == entries[i].size;
+            pos += (long)entries[i].size;
+        }
+        if (fclose(out) != 0) ok = false;
+        if (ok) {
+            printf("Packed %d files into %s (%ld bytes).\n", numFiles, outPath, pos);
+        } else {
+            printf("Failed to write %s\n", outPath);
+            remove(outPath);
+        }
+    }
+
+    for (int i = 0; blobs && i < numFiles; ++i) free(blobs[i]);
+    free(blobs);
+    free(entries);
+    IMG_Quit();
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 // paths.c
 #include "paths.h"
+#include <math.h>
 #include <stdlib.h>
 
 // Intern representation
@@ -56,3 +57,32 @@ SDL_Point leftPointPaths(const Paths *paths, int index) {
 SDL_Point rightPointPaths(const Paths *paths, int index) {
     return paths->right[index];
 }
+
+int circleCoveragePaths(const Paths *paths, int side, float cx, float cy, float radius, PathInterval *out, int maxOut) {
+    if (!paths || !out) return 0;
+    const SDL_Point *points = side == 0 ? paths->left : paths->right;
+    int count = 0;
+    for (int i = 0; i < paths->nmbrOfPoints - 1; ++i) {
+        // |p1 + t*d - c| = r along the segment, t in [0, 1]
+        double dx = points[i + 1].x - points[i].x, dy = points[i + 1].y - points[i].y;
+        double fx = points[i].x - cx, fy = points[i].y - cy;
+        double a = dx * dx + dy * dy;
+        if (a <= 0.0) continue;
+        double b = 2.0 * (fx * dx + fy * dy);
+        double c = fx * fx + fy * fy - (double)radius * radius;
+        double disc = b * b - 4.0 * a * c;
+        if (disc < 0.0) continue;
+        double root = sqrt(disc);
+        double t0 = (-b - root) / (2.0 * a), t1 = (-b + root) / (2.0 * a);
+        if (t1 < 0.0 || t0 > 1.0) continue;
+        float from = (float)i + (float)(t0 < 0.0 ? 0.0 : t0);
+        float to   = (float)i + (float)(t1 > 1.0 ? 1.0 : t1);
+        if (count > 0 && out[count - 1].to >= from) {
+            out[count - 1].to = to; // Continues over the corner
+            continue;
+        }
+        if (count == maxOut) return -1;
+        out[count++] = (PathInterval){ from, to };
+    }
+    return count;
+}
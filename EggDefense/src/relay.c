@@ -0,0 +1,256 @@
+// relay.c
+// Spectator relay: subscribes once to a match (server or another relay) and
+// fans the spectator stream out to many viewers, so broadcasting does not load
+// the authoritative game server. Frames are forwarded as-is (no re-encoding);
+// only the per-connection packet header is restamped. The latest keyframe is
+// cached so late joiners can start decoding immediately.
+//
+// Usage: relay <upstream host[:port]> [-l listen port]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_net.h>
+
+#include "defs.h"
+#include "network.h"
+#include "transport.h"
+#include "fragment.h"
+#include "spectate.h"
+#include "netstats.h"
+
+#define RELAY_STATUS_INTERVAL 5000 // ms between status lines
+
+static volatile sig_atomic_t quitRequested = 0; // Ctrl+C / SIGTERM, the main loop checks it
+
+static void on_quit_signal(int sig) {
+    (void)sig;
+    quitRequested = 1;
+}
+
+typedef struct {
+    IPaddress address;
+    Uint32 lastPacketTime;
+    NetStats stats;
+} RelaySubscriber;
+
+typedef struct {
+    Transport *upstream;    // Ephemeral port towards the server
+    Transport *downstream;  // Listening port for viewers
+    IPaddress upstreamAddress;
+    UDPpacket *packet;
+    Reassembler *reassembler;
+    NetStats upstreamStats;
+    Uint32 lastSpectateSend;
+    Uint16 nextMessageId;
+
+    RelaySubscriber subscribers[RELAY_MAX_SPECTATORS];
+    int numSubscribers;
+
+    // Latest keyframe, ready-made message minus the packet header
+    Uint8 keyframe[SPECTATOR_MAX_FRAME_SIZE];
+    int keyframeLen;
+
+    Uint32 framesIn, framesOut;
+} Relay;
+
+static bool resolve_address(IPaddress *out, const char *spec, int defaultPort) {
+    char host[128];
+    int port = defaultPort;
+    snprintf(host, sizeof host, "%s", spec);
+    char *colon = strrchr(host, ':');
+    if (colon && atoi(colon + 1) > 0) {
+        port = atoi(colon + 1);
+        *colon = '\0';
+    }
+    if (SDLNet_ResolveHost(out, host, (Uint16)port) == -1) {
+        printf("ResolveHost %s failed: %s\n", spec, SDLNet_GetError());
+        return false;
+    }
+    return true;
+}
+
+static void send_frame(Relay *relay, RelaySubscriber *sub, const Uint8 *frame, int len) {
+    static Uint8 message[SERVER_PACKET_HEADER_SIZE + SPECTATOR_MAX_FRAME_SIZE];
+    ServerPacketData header = {.command = SERVER_CMD_SPECTATOR_FRAME};
+    netstats_stamp(&sub->stats, &header.stamp, SDL_GetTicks());
+    memcpy(message, &header, SERVER_PACKET_HEADER_SIZE);
+    memcpy(message + SERVER_PACKET_HEADER_SIZE, frame, (size_t)len);
+    int total = (int)SERVER_PACKET_HEADER_SIZE + len;
+    int fragments = fragment_send(relay->downstream, sub->address, relay->nextMessageId++, message, total);
+    netstats_on_send(&sub->stats, total + fragments * (int)sizeof(FragmentHeader), fragments);
+    relay->framesOut++;
+}
+
+static void handle_upstream_message(Relay *relay, const Uint8 *message, int len, Uint32 now) {
+    if (len < (int)SERVER_PACKET_HEADER_SIZE) return;
+    ServerPacketData header;
+    memcpy(&header, message, SERVER_PACKET_HEADER_SIZE);
+    netstats_on_stamp(&relay->upstreamStats, &header.stamp, now);
+    if (header.command != SERVER_CMD_SPECTATOR_FRAME) return;
+
+    const Uint8 *frame = message + SERVER_PACKET_HEADER_SIZE;
+    int frameLen = len - (int)SERVER_PACKET_HEADER_SIZE;
+    if (frameLen > SPECTATOR_MAX_FRAME_SIZE) return;
+    relay->framesIn++;
+    if (spectator_frame_is_keyframe(frame, frameLen)) {
+        memcpy(relay->keyframe, frame, (size_t)frameLen);
+        relay->keyframeLen = frameLen;
+    }
+    for (int i = 0; i < relay->numSubscribers; ++i) {
+        send_frame(relay, &relay->subscribers[i], frame, frameLen);
+    }
+}
+
+static void receive_upstream(Relay *relay, Uint32 now) {
+    while (transport_recv(relay->upstream, relay->packet) > 0) {
+        UDPpacket *p = relay->packet;
+        if (p->address.host != relay->upstreamAddress.host || p->address.port != relay->upstreamAddress.port) continue;
+        if ((size_t)p->len < sizeof(ServerCommandType)) continue;
+        netstats_on_receive(&relay->upstreamStats, p->len);
+        ServerCommandType command;
+        memcpy(&command, p->data, sizeof command);
+        if (command == SERVER_CMD_FRAGMENT) {
+            int msgLen = 0;
+            const Uint8 *message = reassembler_accept(relay->reassembler, p->data, p->len, now, &msgLen);
+            if (message) handle_upstream_message(relay, message, msgLen, now);
+        } else {
+            handle_upstream_message(relay, p->data, p->len, now);
+        }
+    }
+    // Truncated frames cannot be decoded downstream either, drop them here
+    int len = 0;
+    while (reassembler_expire(relay->reassembler, now, &len) != NULL) {
+    }
+}
+
+static void receive_downstream(Relay *relay, Uint32 now) {
+    while (transport_recv(relay->downstream, relay->packet) > 0) {
+        UDPpacket *p = relay->packet;
+        if ((size_t)p->len < sizeof(ClientCommandType)) continue;
+        ClientPacketData cd = {0};
+        memcpy(&cd, p->data, ((size_t)p->len < sizeof cd) ? (size_t)p->len : sizeof cd);
+        if (cd.command != CLIENT_CMD_SPECTATE) continue; // Viewers only
+
+        RelaySubscriber *sub = NULL;
+        for (int i = 0; i < relay->numSubscribers; ++i) {
+            if (relay->subscribers[i].address.host == p->address.host &&
+                relay->subscribers[i].address.port == p->address.port) {
+                sub = &relay->subscribers[i];
+                break;
+            }
+        }
+        if (!sub) {
+            if (relay->numSubscribers >= RELAY_MAX_SPECTATORS) {
+                ServerPacketData rp = {.command = SERVER_CMD_REJECT_FULL};
+                transport_send(relay->downstream, p->address, &rp, (int)SERVER_PACKET_HEADER_SIZE);
+                continue;
+            }
+            sub = &relay->subscribers[relay->numSubscribers++];
+            memset(sub, 0, sizeof *sub);
+            sub->address = p->address;
+            netstats_reset(&sub->stats, now);
+            if (relay->keyframeLen > 0) send_frame(relay, sub, relay->keyframe, relay->keyframeLen);
+        }
+        sub->lastPacketTime = now;
+        netstats_on_receive(&sub->stats, p->len);
+        netstats_on_stamp(&sub->stats, &cd.stamp, now);
+    }
+
+    for (int i = relay->numSubscribers - 1; i >= 0; --i) {
+        if (now - relay->subscribers[i].lastPacketTime > SERVER_CLIENT_TIMEOUT) {
+            relay->subscribers[i] = relay->subscribers[--relay->numSubscribers];
+        }
+    }
+}
+
+static void keep_upstream_alive(Relay *relay, Uint32 now) {
+    if (now - relay->lastSpectateSend < SPECTATOR_KEEPALIVE_INTERVAL) return;
+    relay->lastSpectateSend = now;
+    ClientPacketData sp = {.command = CLIENT_CMD_SPECTATE, .playerIndex = -1};
+    netstats_stamp(&relay->upstreamStats, &sp.stamp, now);
+    netstats_on_send(&relay->upstreamStats, (int)sizeof sp, 1);
+    transport_send(relay->upstream, relay->upstreamAddress, &sp, (int)sizeof sp);
+}
+
+int main(int argc, char *argv[]) {
+    const char *upstreamSpec = NULL;
+    int listenPort = RELAY_PORT;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) listenPort = atoi(argv[++i]);
+        else if (argv[i][0] != '-') upstreamSpec = argv[i];
+    }
+    if (!upstreamSpec || listenPort <= 0 || listenPort > 65535) {
+        printf("Usage: %s <upstream host[:port]> [-l listen port]\n", argv[0]);
+        return 1;
+    }
+
+    if (SDL_Init(SDL_INIT_TIMER) != 0) {
+        printf("SDL_Init Error: %s\n", SDL_GetError());
+        return 1;
+    }
+    if (SDLNet_Init() != 0) {
+        printf("SDLNet_Init Error: %s\n", SDLNet_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    // After SDL_Init, so these replace any handler SDL installed
+    signal(SIGINT, on_quit_signal);
+    signal(SIGTERM, on_quit_signal);
+
+    Relay *relay = calloc(1, sizeof *relay);
+    bool ok = relay != NULL;
+    if (ok) ok = resolve_address(&relay->upstreamAddress, upstreamSpec, SERVER_PORT);
+    if (ok) {
+        relay->upstream    = transport_open(0);
+        relay->downstream  = transport_open((Uint16)listenPort);
+        relay->packet      = SDLNet_AllocPacket(PACKET_BUFFER_SIZE);
+        relay->reassembler = reassembler_create();
+        ok = relay->upstream && relay->downstream && relay->packet && relay->reassembler;
+    }
+
+    if (ok) {
+        Uint32 now = SDL_GetTicks();
+        netstats_reset(&relay->upstreamStats, now);
+        relay->lastSpectateSend = now - SPECTATOR_KEEPALIVE_INTERVAL; // Subscribe right away
+        printf("Relay: %s -> port %d (%s backend)\n",
+               upstreamSpec, listenPort, transport_backend_name(relay->downstream));
+
+        Uint32 lastStatus = now;
+        while (!quitRequested) {
+            now = SDL_GetTicks();
+            keep_upstream_alive(relay, now);
+            receive_upstream(relay, now);
+            receive_downstream(relay, now);
+            transport_flush(relay->upstream);
+            transport_flush(relay->downstream);
+            netstats_update(&relay->upstreamStats, now);
+
+            if (now - lastStatus >= RELAY_STATUS_INTERVAL) {
+                lastStatus = now;
+                char line[200];
+                netstats_format(&relay->upstreamStats, line, sizeof line);
+                printf("Relay: %d viewers, frames in %u out %u, upstream %s\n",
+                       relay->numSubscribers, (unsigned)relay->framesIn, (unsigned)relay->framesOut, line);
+            }
+            SDL_Delay(1);
+        }
+        printf("Relay: shutting down.\n");
+    } else {
+        printf("Relay startup failed.\n");
+    }
+
+    if (relay) {
+        reassembler_destroy(relay->reassembler);
+        if (relay->packet) SDLNet_FreePacket(relay->packet);
+        transport_close(relay->upstream);
+        transport_close(relay->downstream);
+        free(relay);
+    }
+    SDLNet_Quit();
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
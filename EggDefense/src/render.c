@@ -3,20 +3,6 @@
 #include <math.h>
 #include "engine.h"
 
-void render_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, SDL_Color color, bool center) {
-    if (!font || !text || !renderer || strlen(text) == 0) return;
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
-    if (!surface) return;
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    if (!texture) return;
-    SDL_Rect dstRect = {x, y, 0, 0};
-    SDL_QueryTexture(texture, NULL, NULL, &dstRect.w, &dstRect.h);
-    if (center) dstRect.x = x - dstRect.w / 2;
-    SDL_RenderCopy(renderer, texture, NULL, &dstRect);
-    SDL_DestroyTexture(texture);
-}
-
 // Main Rendering Functions
 void render_main_menu(SDL_Renderer *renderer, GameResources *resources, BuildMode mode) {
     if (!renderer || !resources || !resources->mainMenuBg || !resources->font) {
@@ -34,15 +20,42 @@ void render_main_menu(SDL_Renderer *renderer, GameResources *resources, BuildMod
     if (mode == MODE_SINGLEPLAYER) menu_text = "Press SPACE to Play Singleplayer";
     else if (mode == MODE_SERVER) menu_text = "Press SPACE to Host Game";
     else if (mode == MODE_CLIENT) menu_text = "Press SPACE to Join Game";
-    render_text(renderer, resources->font, menu_text, WINDOW_WIDTH / 2, text_y, white, true);
+    render_text(resources->textCache, menu_text, WINDOW_WIDTH / 2, text_y, white, true);
     SDL_RenderPresent(renderer);
 }
 
-void render_game(SDL_Renderer *renderer, GameState *gameState, GameResources *resources,
-                 float birdRotations[], bool placingBird, int selectedOption, int localPlayerIndex) {
-    if (!renderer || !gameState || !resources) return;
+// Sprite sizes on screen, from the original image sizes
+static SDL_Rect enemy_render_size(const GameResources *resources) {
+    SDL_Rect r = {0, 0, 0, 0};
+    if (resources->enemySprites[0].texture) {
+        r.w = (int)(resources->enemySprites[0].w * ENEMY_RENDER_SCALE_WIDTH);
+        r.h = (int)(resources->enemySprites[0].h * ENEMY_RENDER_SCALE_HEIGHT);
+    } else {
+        r.w = WINDOW_WIDTH * ENEMY_RENDER_SCALE_WIDTH;
+        r.h = WINDOW_HEIGHT * ENEMY_RENDER_SCALE_HEIGHT;
+    }
+    return r;
+}
 
-    // Map Rendering (remains the same)
+static SDL_Rect bird_render_size(const GameResources *resources) {
+    SDL_Rect r = {0, 0, 40, 40};
+    if (resources->towerBaseSprites[0].texture) {
+        r.w = (int)(resources->towerBaseSprites[0].w * BIRD_RENDER_SCALE);
+        r.h = (int)(resources->towerBaseSprites[0].h * BIRD_RENDER_SCALE);
+    }
+    return r;
+}
+
+static SDL_Rect projectile_render_size(const GameResources *resources) {
+    SDL_Rect r = {0, 0, 10, 10};
+    if (resources->projectileSprites[0].texture) {
+        r.w = (int)(resources->projectileSprites[0].w * PROJECTILE_RENDER_SCALE);
+        r.h = (int)(resources->projectileSprites[0].h * PROJECTILE_RENDER_SCALE);
+    }
+    return r;
+}
+
+static void draw_map(SDL_Renderer *renderer, const GameResources *resources) {
     if (resources->mapTexture) {
         SDL_Rect mapRect = {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
         SDL_RenderCopy(renderer, resources->mapTexture, NULL, &mapRect);
@@ -50,149 +63,224 @@ void render_game(SDL_Renderer *renderer, GameState *gameState, GameResources *re
         SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
         SDL_RenderClear(renderer);
     }
+}
+
+// Entities store sprite indices, the sprites live in resources. NULL for
+// indices a snapshot got wrong.
+static const Sprite *enemy_sprite(const GameResources *resources, const Enemy *e) {
+    return (e->spriteIndex >= 0 && e->spriteIndex < 3) ? &resources->enemySprites[e->spriteIndex] : NULL;
+}
+
+static const Sprite *bird_sprite(const GameResources *resources, const Bird *b) {
+    if (b->towerTypeIndex < 0 || b->towerTypeIndex >= 3) return NULL;
+    return (b->attackAnimTimer > 0) ? &resources->towerAttackSprites[b->towerTypeIndex]
+                                    : &resources->towerBaseSprites[b->towerTypeIndex];
+}
+
+static const Sprite *projectile_sprite(const GameResources *resources, const Projectile *p) {
+    return (p->textureIndex >= 0 && p->textureIndex < 2) ? &resources->projectileSprites[p->textureIndex] : NULL;
+}
+
+// Towers never move, so their shadows belong to the static layer
+static void draw_bird_shadows(GameResources *resources, const GameState *gameState) {
+    const Sprite *shadow = &resources->shadow;
+    if (!shadow->texture) return;
+    SDL_Rect baseBirdRect = bird_render_size(resources);
+    float shadowW = baseBirdRect.w * 1.0f;
+    float shadowH = baseBirdRect.h * 0.4f;
+    for (int i = 0; i < gameState->numPlacedBirds; i++) {
+        const Bird *b = &gameState->placedBirds[i];
+        if (!b->active || !bird_sprite(resources, b)) continue;
+        spritebatch_add(resources->spriteBatch, shadow->texture, &shadow->src,
+                        b->x, b->y + baseBirdRect.h * 0.1f + shadowH / 2.0f,
+                        shadowW, shadowH, 0.0f, 160);
+    }
+    spritebatch_flush(resources->spriteBatch);
+}
+
+// Bit i set = tower option i is affordable for the team
+static int affordable_mask(const GameState *gameState, const GameResources *resources, Team team) {
+    int balance = money_manager_get_balance(&gameState->team_money[team]);
+    int mask = 0;
+    for (int i = 0; i < 3; i++) {
+        if (balance >= resources->towerOptions[i].prototype.cost) mask |= 1 << i;
+    }
+    return mask;
+}
+
+// HP bar frames, tower icons and prices: only change with affordability
+static void draw_static_hud(SDL_Renderer *renderer, GameResources *resources, int affordable) {
+    if (!resources->font) return;
+    char buf[64];
+    SDL_Color r = {255,0,0,255}; // red
+    SDL_Color g = {144, 238, 144, 255}; // green
+
+    // HP Bar frames
+    SDL_Rect ol = { HP_BAR_MARGIN_X, HP_BAR_Y, HP_BAR_WIDTH, HP_BAR_HEIGHT };
+    SDL_Rect or_rect = { WINDOW_WIDTH-HP_BAR_MARGIN_X-HP_BAR_WIDTH, HP_BAR_Y, HP_BAR_WIDTH, HP_BAR_HEIGHT };
+    SDL_SetRenderDrawColor(renderer, 255,255,255,255);
+    SDL_RenderDrawRect(renderer, &ol);
+    SDL_RenderDrawRect(renderer, &or_rect);
+
+    // Tower Icons
+    for(int i=0; i<3; i++){
+        const TowerOption *o = &resources->towerOptions[i];
+        const Sprite *icon = o->iconSprite;
+        if(icon && icon->texture){
+            bool canAfford = (affordable & (1 << i)) != 0;
+            SDL_SetTextureColorMod(icon->texture, canAfford?255:100, canAfford?255:100, canAfford?255:100);
+            SDL_RenderCopy(renderer, icon->texture, &icon->src, &o->iconRect);
+            SDL_SetTextureColorMod(icon->texture, 255,255,255); // Shared atlas page
+            snprintf(buf, sizeof(buf), "$%d", o->prototype.cost);
+            render_text(resources->textCache, buf, o->iconRect.x+o->iconRect.w/2, o->iconRect.y+o->iconRect.h+2, canAfford?g:r, true);
+        }
+    }
+}
+
+void render_invalidate_static_layer(GameResources *resources) {
+    if (resources) resources->staticLayer.valid = false;
+}
+
+// Rebakes map + tower shadows + static HUD if towers or affordability changed.
+// Returns false if render targets are unavailable (draw everything directly).
+static bool update_static_layer(SDL_Renderer *renderer, GameState *gameState, GameResources *resources, int affordable) {
+    StaticLayer *layer = &resources->staticLayer;
+    if (!layer->texture) return false;
+    if (layer->valid && layer->towerVersion == gameState->towerVersion && layer->affordable == affordable) return true;
+
+    if (SDL_SetRenderTarget(renderer, layer->texture) != 0) {
+        printf("Static layer: SDL_SetRenderTarget failed, drawing directly: %s\n", SDL_GetError());
+        SDL_DestroyTexture(layer->texture);
+        layer->texture = NULL;
+        return false;
+    }
+    draw_map(renderer, resources);
+    draw_bird_shadows(resources, gameState);
+    draw_static_hud(renderer, resources, affordable);
+    SDL_SetRenderTarget(renderer, NULL);
+
+    layer->valid = true;
+    layer->towerVersion = gameState->towerVersion;
+    layer->affordable = affordable;
+    return true;
+}
+
+void render_game(SDL_Renderer *renderer, GameState *gameState, GameResources *resources,
+                 float birdRotations[], bool placingBird, int selectedOption, int localPlayerIndex) {
+    if (!renderer || !gameState || !resources) return;
 
-    // Enemy Rendering (remains the same)
-    SDL_Rect baseEnemyRect; if (resources->enemyTextures[0]) {
-        int w,h;
-        SDL_QueryTexture(resources->enemyTextures[0], NULL, NULL, &w, &h);
-        baseEnemyRect.w = (int)(w * ENEMY_RENDER_SCALE_WIDTH);
-        baseEnemyRect.h = (int)(h * ENEMY_RENDER_SCALE_HEIGHT);
+    Team team = (localPlayerIndex == 0 || localPlayerIndex == 2) ? TEAM_LEFT : TEAM_RIGHT;
+    int affordable = affordable_mask(gameState, resources, team);
+
+    // Static layer: map, tower shadows and HUD frame, rebaked only on change
+    if (update_static_layer(renderer, gameState, resources, affordable)) {
+        SDL_Rect layerRect = {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
+        SDL_RenderCopy(renderer, resources->staticLayer.texture, NULL, &layerRect);
     } else {
-        baseEnemyRect.w = WINDOW_WIDTH * ENEMY_RENDER_SCALE_WIDTH;
-        baseEnemyRect.h = WINDOW_HEIGHT * ENEMY_RENDER_SCALE_HEIGHT;
+        draw_map(renderer, resources);
+        draw_bird_shadows(resources, gameState);
+        draw_static_hud(renderer, resources, affordable);
     }
+
+    // Dynamic map sprites are batched per layer: shadows, enemies, birds,
+    // projectiles. They all live in the atlas, so each layer is one draw call.
+    SpriteBatch *batch = resources->spriteBatch;
+    SDL_Rect baseEnemyRect = enemy_render_size(resources);
+    SDL_Rect baseBirdRect = bird_render_size(resources);
+    SDL_Rect baseProjRect = projectile_render_size(resources);
+
+    // Enemy shadows
+    const Sprite *shadow = &resources->shadow;
+    if (shadow->texture) {
+        float shadowW = baseEnemyRect.w * 1.0f;
+        float shadowH = baseEnemyRect.h * 0.3f;
+        for (int i = 0; i < gameState->numEnemiesActive; i++) {
+            Enemy *e = &gameState->enemies[i];
+            if (!e->active || !enemy_sprite(resources, e)) continue;
+            spritebatch_add(batch, shadow->texture, &shadow->src,
+                            e->x, e->y + baseEnemyRect.h * 0.07f + shadowH / 2.0f,
+                            shadowW, shadowH, 0.0f, 140);
+        }
+        spritebatch_flush(batch);
+    }
+
+    // Enemies
     for (int i = 0; i < gameState->numEnemiesActive; i++) {
         Enemy *e = &gameState->enemies[i];
-        if (!e->active || !e->texture) continue;
-        int shadowW = (int)(baseEnemyRect.w * 1.0f);
-        int shadowH = (int)(baseEnemyRect.h * 0.3f);
-        SDL_Rect shadowRect = {
-            (int)(e->x - shadowW / 2),
-            (int)(e->y + baseEnemyRect.h * 0.07f),
-            shadowW,
-            shadowH
-        };
-        SDL_SetTextureAlphaMod(resources->shadow, 140); 
-        SDL_RenderCopy(renderer, resources->shadow, NULL, &shadowRect);
-        SDL_Rect r = { (int)(e->x - baseEnemyRect.w / 2.0f), (int)(e->y - baseEnemyRect.h / 2.0f), baseEnemyRect.w, baseEnemyRect.h };
-        SDL_Point p = { baseEnemyRect.w / 2, baseEnemyRect.h / 2 };
-        SDL_RenderCopyEx(renderer, e->texture, NULL, &r, e->angle+180, &p, SDL_FLIP_NONE);
+        const Sprite *sprite = enemy_sprite(resources, e);
+        if (!e->active || !sprite) continue;
+        spritebatch_add(batch, sprite->texture, &sprite->src, e->x, e->y,
+                        (float)baseEnemyRect.w, (float)baseEnemyRect.h, e->angle + 180.0f, 255);
     }
+    spritebatch_flush(batch);
 
-    // Tower (Bird) Rendering (remains the same)
-    SDL_Rect baseBirdRect;
-    if (resources->towerBaseTextures[0]) {
-        int w,h;
-        SDL_QueryTexture(resources->towerBaseTextures[0], NULL, NULL, &w, &h);
-        baseBirdRect.w = (int)(w * BIRD_RENDER_SCALE);
-        baseBirdRect.h = (int)(h * BIRD_RENDER_SCALE);
-    } else {
-        baseBirdRect.w = 40; baseBirdRect.h = 40;
-    }
+    // Towers (Birds), rotate towards their targets so they stay dynamic
     for (int i = 0; i < gameState->numPlacedBirds; i++) {
         Bird *b = &gameState->placedBirds[i];
-        if (!b->active || !b->texture) continue;
-        int shadowW = (int)(baseBirdRect.w * 1.0f);
-        int shadowH = (int)(baseBirdRect.h * 0.4f);
-        SDL_Rect shadowRect = {
-            (int)(b->x - shadowW / 2),
-            (int)(b->y + baseBirdRect.h * 0.1f),
-            shadowW,
-            shadowH
-        };
-        SDL_SetTextureAlphaMod(resources->shadow, 160);
-        SDL_RenderCopy(renderer, resources->shadow, NULL, &shadowRect);
-        SDL_Rect r = { (int)(b->x - baseBirdRect.w / 2.0f), (int)(b->y - baseBirdRect.h / 2.0f), baseBirdRect.w, baseBirdRect.h };
-        SDL_Point p = { baseBirdRect.w / 2, baseBirdRect.h / 2 };
-        SDL_RenderCopyEx(renderer, b->texture, NULL, &r, birdRotations[i], &p, SDL_FLIP_NONE);
+        const Sprite *sprite = bird_sprite(resources, b);
+        if (!b->active || !sprite) continue;
+        spritebatch_add(batch, sprite->texture, &sprite->src, b->x, b->y,
+                        (float)baseBirdRect.w, (float)baseBirdRect.h, birdRotations[i], 255);
     }
+    spritebatch_flush(batch);
 
-    // Projectile Rendering (remains the same)
-    SDL_Rect baseProjRect;
-    if (resources->projectileTextures[0]) {
-        int w,h;
-        SDL_QueryTexture(resources->projectileTextures[0], NULL, NULL, &w, &h);
-        baseProjRect.w = (int)(w * PROJECTILE_RENDER_SCALE);
-        baseProjRect.h = (int)(h * PROJECTILE_RENDER_SCALE);
-    } else {
-        baseProjRect.w = 10; baseProjRect.h = 10;
-    }
+    // Projectiles
     for (int i = 0; i < gameState->numProjectiles; i++) {
         Projectile *p = &gameState->projectiles[i];
-        if (!p->active || !p->texture) continue;
-        SDL_Rect r = { (int)(p->x - baseProjRect.w / 2.0f), (int)(p->y - baseProjRect.h / 2.0f), baseProjRect.w, baseProjRect.h };
-        SDL_Point pv = { baseProjRect.w / 2, baseProjRect.h / 2 };
-        SDL_RenderCopyEx(renderer, p->texture, NULL, &r, p->angle, &pv, SDL_FLIP_NONE);
+        const Sprite *sprite = projectile_sprite(resources, p);
+        if (!p->active || !sprite) continue;
+        spritebatch_add(batch, sprite->texture, &sprite->src, p->x, p->y,
+                        (float)baseProjRect.w, (float)baseProjRect.h, p->angle, 255);
     }
+    spritebatch_flush(batch);
 
-    // UI Rendering (Updated parts)
+    // Dynamic UI: money, wave, team and HP
     if (resources->font) {
         char buf[64];
         SDL_Color w = {255,255,255,255}; // white
         SDL_Color y = {255,255,0,255}; // yellow
-        SDL_Color r = {255,0,0,255}; // red
-        SDL_Color g = {144, 238, 144, 255}; // green
 
         int uy=10; // 10px från toppen
 
-        Team team = (localPlayerIndex == 0 || localPlayerIndex == 2) ? TEAM_LEFT : TEAM_RIGHT;
-        int currentMoney = money_manager_get_balance(gameState->team_money[team]);
+        int currentMoney = money_manager_get_balance(&gameState->team_money[team]);
         snprintf(buf, sizeof(buf), "Money: $%d", currentMoney);
-        render_text(renderer, resources->font, buf, WINDOW_WIDTH / 2, uy, y, true);
+        render_text(resources->textCache, buf, WINDOW_WIDTH / 2, uy, y, true);
 
         // Wave text 
         int wy = uy + 30; // 30px under money 
         snprintf(buf, sizeof(buf), "Wave: %d", gameState->currentWave);
-        render_text(renderer, resources->font, buf, WINDOW_WIDTH / 2, wy, w, true);
+        render_text(resources->textCache, buf, WINDOW_WIDTH / 2, wy, w, true);
 
         // Team text 
         if (localPlayerIndex >= 0) {
             const char *teamStr = (team == TEAM_LEFT) ? "Team Left" : "Team Right";
             int ty = wy + 30;
-            render_text(renderer, resources->font, teamStr, WINDOW_WIDTH/2, ty, w, true);
+            render_text(resources->textCache, teamStr, WINDOW_WIDTH/2, ty, w, true);
         }
 
-        // HP Bars 
-        int bw = (int)(WINDOW_WIDTH * 0.1f);
-        int bh = (int)(WINDOW_HEIGHT * 0.02f);
-        int hy = uy + 30;
-        int xo = 50;
+        // HP Bars (frames are in the static layer)
+        int bw = HP_BAR_WIDTH;
+        int bh = HP_BAR_HEIGHT;
+        int hy = HP_BAR_Y;
+        int xo = HP_BAR_MARGIN_X;
         // Left HP Bar
-        SDL_Rect ol = { xo, hy, bw, bh };
         float frl = (gameState->leftPlayerHP > 0)?(float)gameState->leftPlayerHP/PLAYER_START_HP:0.0f;
         if (frl < 0.0f) {frl = 0.0f;}
         if (frl > 1.0f) {frl = 1.0f;}
-        SDL_Rect fl = { ol.x+1, ol.y+1, (int)(bw * frl)-2, bh-2 };
-        SDL_SetRenderDrawColor(renderer, 255,255,255,255); SDL_RenderDrawRect(renderer, &ol);
+        SDL_Rect fl = { xo+1, hy+1, (int)(bw * frl)-2, bh-2 };
         SDL_SetRenderDrawColor(renderer, 0,200,0,255); if(fl.w>0&&fl.h>0) SDL_RenderFillRect(renderer, &fl);
         snprintf(buf, sizeof(buf), "%d/%d", gameState->leftPlayerHP<0?0:gameState->leftPlayerHP, PLAYER_START_HP);
-        render_text(renderer, resources->font, buf, xo+bw+5, hy, w, false);
+        render_text(resources->textCache, buf, xo+bw+5, hy, w, false);
         // Right HP Bar
-        SDL_Rect or_rect = { WINDOW_WIDTH-xo-bw, hy, bw, bh };
+        int rx = WINDOW_WIDTH-xo-bw;
         float frr = (gameState->rightPlayerHP>0)?(float)gameState->rightPlayerHP/PLAYER_START_HP:0.0f;
         if (frr < 0.0f) {frr = 0.0f;}
         if (frr > 1.0f) {frr = 1.0f;}
-        SDL_Rect fillr = { or_rect.x+1, or_rect.y+1, (int)(bw * frr)-2, bh-2 };
-        SDL_SetRenderDrawColor(renderer, 255,255,255,255); SDL_RenderDrawRect(renderer, &or_rect);
+        SDL_Rect fillr = { rx+1, hy+1, (int)(bw * frr)-2, bh-2 };
         SDL_SetRenderDrawColor(renderer, 0,200,0,255); if(fillr.w>0&&fillr.h>0) SDL_RenderFillRect(renderer, &fillr);
         snprintf(buf, sizeof(buf), "%d/%d", gameState->rightPlayerHP<0?0:gameState->rightPlayerHP, PLAYER_START_HP);
-        int tw, th; TTF_SizeText(resources->font, buf, &tw, &th);
-        render_text(renderer, resources->font, buf, or_rect.x-tw-5, hy, w, false);
-
-        // Tower Icons 
-        for(int i=0; i<3; i++){
-            const TowerOption *o = &resources->towerOptions[i];
-            if(o->iconTexture){
-                Team team = (localPlayerIndex == 0 || localPlayerIndex == 2) ? TEAM_LEFT : TEAM_RIGHT; 
-                bool canAfford = (money_manager_get_balance(gameState->team_money[team]) >= o->prototype.cost);
-
-                SDL_SetTextureColorMod(o->iconTexture, canAfford?255:100, canAfford?255:100, canAfford?255:100);
-                SDL_RenderCopy(renderer, o->iconTexture, NULL, &o->iconRect);
-                SDL_SetTextureColorMod(o->iconTexture, 255,255,255); 
-                snprintf(buf, sizeof(buf), "$%d", o->prototype.cost);
-                render_text(renderer, resources->font, buf, o->iconRect.x+o->iconRect.w/2, o->iconRect.y+o->iconRect.h+2, canAfford?g:r, true);
-            }
-        }
+        int tw, th; text_cache_measure(resources->textCache, buf, w, &tw, &th);
+        render_text(resources->textCache, buf, rx-tw-5, hy, w, false);
     }
 
     // Placement Preview 
@@ -211,18 +299,16 @@ void render_game(SDL_Renderer *renderer, GameState *gameState, GameResources *re
 void render_placement_preview(SDL_Renderer *renderer, GameResources *resources, int selectedOption, int mouseX, int mouseY) {
     if (selectedOption < 0 || selectedOption >= 3 || !resources) return;
     const TowerOption *o = &resources->towerOptions[selectedOption];
-    SDL_Texture *pt = o->prototype.baseTexture;
-    if (!pt) return;
+    const Sprite *pt = &resources->towerBaseSprites[o->prototype.towerTypeIndex];
+    if (!pt || !pt->texture) return;
     SDL_Rect pr;
-    int w,h;
-    SDL_QueryTexture(pt, NULL, NULL, &w, &h);
-    pr.w = (int)(w * BIRD_RENDER_SCALE);
-    pr.h = (int)(h * BIRD_RENDER_SCALE);
+    pr.w = (int)(pt->w * BIRD_RENDER_SCALE);
+    pr.h = (int)(pt->h * BIRD_RENDER_SCALE);
     pr.x = mouseX - pr.w/2;
     pr.y = mouseY - pr.h/2;
-    SDL_SetTextureAlphaMod(pt, 150);
-    SDL_RenderCopy(renderer, pt, NULL, &pr);
-    SDL_SetTextureAlphaMod(pt, 255);
+    SDL_SetTextureAlphaMod(pt->texture, 150);
+    SDL_RenderCopy(renderer, pt->texture, &pt->src, &pr);
+    SDL_SetTextureAlphaMod(pt->texture, 255);
     int range = (int)o->prototype.range;
     SDL_SetRenderDrawColor(renderer, 255,0,0,130);
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
@@ -240,13 +326,13 @@ void render_placement_preview(SDL_Renderer *renderer, GameResources *resources,
     SDL_SetRenderDrawColor(renderer, 0,0,0,255);
 }
 
-void render_game_over(SDL_Renderer* renderer, GameResources* resources, const char* message) {
+void render_game_over(SDL_Renderer* renderer, GameResources* resources, const char* message, bool canRematch) {
     if (!renderer || !resources || !resources->font || !message) return;
     SDL_Color r={255,0,0,255};
     SDL_Color w={255,255,255,255};
     SDL_Color bg={50,50,50,200};
     int tw,th;
-    TTF_SizeText(resources->font, message, &tw, &th);
+    text_cache_measure(resources->textCache, message, r, &tw, &th);
     int x=WINDOW_WIDTH/2-tw/2;
     int y=WINDOW_HEIGHT/2-th/2-30;
     SDL_Rect bgr = { x-20, y-10, tw+40, th+20 };
@@ -254,8 +340,83 @@ void render_game_over(SDL_Renderer* renderer, GameResources* resources, const ch
     SDL_SetRenderDrawColor(renderer, bg.r, bg.g, bg.b, bg.a);
     SDL_RenderFillRect(renderer, &bgr);
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
-    render_text(renderer, resources->font, message, x, y, r, false);
-    const char* qm = "Press ESC to return to menu or quit";
-    TTF_SizeText(resources->font, qm, &tw, &th);
-    render_text(renderer, resources->font, qm, WINDOW_WIDTH/2, bgr.y+bgr.h+10, w, true);
-}
\ No newline at end of file
+    render_text(resources->textCache, message, x, y, r, false);
+    const char* qm = canRematch ? "Press SPACE for a rematch, ESC to return to menu"
+                                : "Press ESC to return to menu or quit";
+    text_cache_measure(resources->textCache, qm, w, &tw, &th);
+    render_text(resources->textCache, qm, WINDOW_WIDTH/2, bgr.y+bgr.h+10, w, true);
+}
+// Draws one frame from the render queue (render thread only) and presents it
+void render_frame(SDL_Renderer *renderer, GameResources *resources, RenderFrame *frame, BuildMode mode) {
+    static GameState interpState; // Interpolated copy, the frame may be drawn again (large, keep off the stack)
+    if (!renderer || !resources || !frame) return;
+    SDL_Color white = {255, 255, 255, 255};
+
+    switch (frame->view) {
+        case RENDER_VIEW_MENU:
+            render_main_menu(renderer, resources, mode); // Presents itself
+            return;
+
+        case RENDER_VIEW_STATUS:
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderClear(renderer);
+            render_text(resources->textCache, frame->statusText, 10, WINDOW_HEIGHT - 30, white, false);
+            break;
+
+        case RENDER_VIEW_GAME:
+        case RENDER_VIEW_GAME_OVER: {
+            GameState *gs = &frame->state;
+            if (frame->stepCounter != 0) {
+                // Where real time is between the latest step and the next one
+                Uint64 elapsed = SDL_GetPerformanceCounter() - frame->stepCounter;
+                float alpha = (float)elapsed * SINGLEPLAYER_SIM_RATE / (float)SDL_GetPerformanceFrequency();
+                interpState = frame->state;
+                interp_apply(&frame->previous, &interpState, alpha);
+                gs = &interpState;
+            }
+            bool gameOver = frame->view == RENDER_VIEW_GAME_OVER;
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderClear(renderer);
+            render_game(renderer, gs, resources, frame->birdRotations,
+                        gameOver ? false : frame->placingBird, gameOver ? -1 : frame->selectedOption, frame->playerIndex);
+            if (gameOver) render_game_over(renderer, resources, frame->overlayText, frame->canRematch);
+            else render_text(resources->textCache, frame->statusText, 10, WINDOW_HEIGHT - 30, white, false);
+            render_text(resources->textCache, frame->netStatsLine, 10, WINDOW_HEIGHT - 60, (SDL_Color){255, 255, 0, 255}, false);
+            break;
+        }
+
+        case RENDER_VIEW_ERROR:
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderClear(renderer);
+            render_text(resources->textCache, frame->statusText, WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2, (SDL_Color){255, 0, 0, 255}, true);
+            render_text(resources->textCache, "Press ESC to quit", WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2 + 30, white, true);
+            break;
+    }
+    SDL_RenderPresent(renderer);
+}
+
+// Loading screen, redrawn by load_resources each time an asset is decoded
+void render_loading_screen(SDL_Renderer *renderer, GameResources *resources, int done, int total) {
+    if (!renderer || !resources) return;
+    SDL_PumpEvents(); // Keep the window responsive while loading
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    if (resources->mainMenuBg) {
+        SDL_Rect bgRect = {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
+        SDL_RenderCopy(renderer, resources->mainMenuBg, NULL, &bgRect);
+    }
+
+    int barW = WINDOW_WIDTH / 3;
+    int barH = 16;
+    SDL_Rect frame = { WINDOW_WIDTH / 2 - barW / 2, WINDOW_HEIGHT / 2, barW, barH };
+    SDL_Rect fill = { frame.x + 2, frame.y + 2, total > 0 ? (barW - 4) * done / total : 0, barH - 4 };
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDrawRect(renderer, &frame);
+    if (fill.w > 0) SDL_RenderFillRect(renderer, &fill);
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "Loading... %d/%d", done, total);
+    render_text(resources->textCache, buf, WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2 - 40, (SDL_Color){255, 255, 255, 255}, true);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderPresent(renderer);
+}
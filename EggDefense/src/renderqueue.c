@@ -0,0 +1,99 @@
+// renderqueue.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "renderqueue.h"
+
+#define FRAME_FRESH 4 // Set in middle when the writer published a new frame
+
+// Intern representation, same triple buffer and ring as locallink.c
+struct RenderQueue {
+    // The writer owns back, the reader owns front, middle is exchanged atomically
+    RenderFrame frames[3];
+    int back;
+    int front;
+    SDL_atomic_t middle;
+    bool hasFrame; // Reader only: front holds a published frame
+
+    SDL_Event input[RENDER_INPUT_QUEUE_SIZE];
+    SDL_atomic_t inputHead; // Next slot to write (render thread only)
+    SDL_atomic_t inputTail; // Next slot to read (logic thread only)
+};
+
+RenderQueue *render_queue_create(void) {
+    RenderQueue *q = calloc(1, sizeof *q);
+    if (!q) {
+        printf("Error: Failed to allocate render queue\n");
+        return NULL;
+    }
+    q->back  = 0;
+    q->front = 1;
+    SDL_AtomicSet(&q->middle, 2);
+    return q;
+}
+
+void render_queue_destroy(RenderQueue *q) {
+    free(q);
+}
+
+RenderFrame *render_queue_begin(RenderQueue *q) {
+    return &q->frames[q->back];
+}
+
+void render_queue_publish(RenderQueue *q) {
+    // SDL_AtomicSet is a full-barrier exchange, so the filled frame is visible
+    // before the reader can pick it up
+    int old = SDL_AtomicSet(&q->middle, q->back | FRAME_FRESH);
+    q->back = old & 3;
+}
+
+RenderFrame *render_queue_acquire(RenderQueue *q) {
+    if (SDL_AtomicGet(&q->middle) & FRAME_FRESH) {
+        int old = SDL_AtomicSet(&q->middle, q->front);
+        q->front = old & 3;
+        q->hasFrame = true;
+    }
+    return q->hasFrame ? &q->frames[q->front] : NULL;
+}
+
+bool render_queue_push_input(RenderQueue *q, const SDL_Event *event) {
+    if (!q || !event) return false;
+    int head = SDL_AtomicGet(&q->inputHead);
+    int tail = SDL_AtomicGet(&q->inputTail);
+    if (head - tail >= RENDER_INPUT_QUEUE_SIZE) return false;
+
+    q->input[head % RENDER_INPUT_QUEUE_SIZE] = *event;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&q->inputHead, head + 1);
+    return true;
+}
+
+bool render_queue_pop_input(RenderQueue *q, SDL_Event *event) {
+    if (!q || !event) return false;
+    int tail = SDL_AtomicGet(&q->inputTail);
+    int head = SDL_AtomicGet(&q->inputHead);
+    if (tail == head) return false;
+    SDL_MemoryBarrierAcquire();
+
+    *event = q->input[tail % RENDER_INPUT_QUEUE_SIZE];
+    SDL_AtomicSet(&q->inputTail, tail + 1);
+    return true;
+}
+
+
+bool render_queue_pump_events(RenderQueue *q, GameResources *resources) {
+    bool closed = false;
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        if (event.type == SDL_QUIT) closed = true;
+        // Render target contents are lost (e.g. Direct3D device reset)
+        if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+            render_invalidate_static_layer(resources);
+        }
+        // Only what the game reacts to, motion events would flood the ring
+        else if (event.type == SDL_QUIT || event.type == SDL_KEYDOWN || event.type == SDL_MOUSEBUTTONDOWN) {
+            if (!render_queue_push_input(q, &event)) printf("Render queue: input ring full, event dropped\n");
+        }
+    }
+    return closed;
+}
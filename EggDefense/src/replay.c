@@ -0,0 +1,300 @@
+// replay.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+
+#define REPLAY_WRITE_BUFFER (64 * 1024) // Recording reaches the disk in blocks this big
+
+// --- Recording ---
+
+// Intern representation
+struct ReplayRecorder {
+    FILE *file;
+    Uint32 offset;          // Bytes written so far
+    Uint32 spanStart;       // Tick of the latest keyframe
+    Uint32 lastTick;
+    ReplayEvent *events;    // Since the latest keyframe
+    int numEvents;
+    int eventCapacity;
+    ReplayIndexEntry *index;
+    int numKeyframes;
+    int indexCapacity;
+    bool outOfMemory;
+    Uint8 keyframe[SAVESTATE_MAX_SIZE];
+};
+
+static void write_chunk(ReplayRecorder *rec, Uint32 type, Uint32 tick, const void *data, size_t size) {
+    ReplayChunkHeader hdr = { type, tick, (Uint32)size };
+    fwrite(&hdr, sizeof hdr, 1, rec->file);
+    if (size > 0) fwrite(data, 1, size, rec->file);
+    rec->offset += (Uint32)(sizeof hdr + size);
+}
+
+// Doubles *capacity when full, false (and nothing changed) if that fails
+static bool grow(void **items, int count, int *capacity, size_t itemSize) {
+    if (count < *capacity) return true;
+    int newCapacity = *capacity ? *capacity * 2 : 64;
+    void *grown = realloc(*items, (size_t)newCapacity * itemSize);
+    if (!grown) return false;
+    *items = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+static void write_keyframe(ReplayRecorder *rec, const GameState *gameState, Uint32 tick) {
+    if (!grow((void **)&rec->index, rec->numKeyframes, &rec->indexCapacity, sizeof(ReplayIndexEntry))) {
+        rec->outOfMemory = true;
+        return;
+    }
+    rec->index[rec->numKeyframes++] = (ReplayIndexEntry){ tick, rec->offset };
+    size_t size = savestate_encode(gameState, tick, rec->keyframe, sizeof rec->keyframe);
+    write_chunk(rec, REPLAY_CHUNK_KEYFRAME, tick, rec->keyframe, size);
+    rec->spanStart = tick;
+    fflush(rec->file); // Readable up to here even if the process dies
+}
+
+static void flush_events(ReplayRecorder *rec) {
+    write_chunk(rec, REPLAY_CHUNK_EVENTS, rec->spanStart, rec->events, (size_t)rec->numEvents * sizeof(ReplayEvent));
+    rec->numEvents = 0;
+}
+
+static void push_event(ReplayRecorder *rec, const ReplayEvent *event) {
+    if (!grow((void **)&rec->events, rec->numEvents, &rec->eventCapacity, sizeof(ReplayEvent))) {
+        if (!rec->outOfMemory) printf("Replay: out of memory, events are being dropped.\n");
+        rec->outOfMemory = true;
+        return;
+    }
+    rec->events[rec->numEvents++] = *event;
+}
+
+ReplayRecorder *replay_recorder_open(const char *path, const GameState *gameState, Uint32 tick) {
+    if (!path || !gameState) return NULL;
+    ReplayRecorder *rec = calloc(1, sizeof *rec);
+    if (!rec) return NULL;
+    rec->file = fopen(path, "wb");
+    if (!rec->file) {
+        perror(path);
+        free(rec);
+        return NULL;
+    }
+    setvbuf(rec->file, NULL, _IOFBF, REPLAY_WRITE_BUFFER);
+    rec->lastTick = tick;
+    ReplayFileHeader hdr = { REPLAY_MAGIC, REPLAY_VERSION, GAME_TICK_RATE, REPLAY_KEYFRAME_INTERVAL };
+    fwrite(&hdr, sizeof hdr, 1, rec->file);
+    rec->offset = sizeof hdr;
+    write_keyframe(rec, gameState, tick);
+    return rec;
+}
+
+void replay_record_place_tower(ReplayRecorder *rec, Uint32 tick, int playerIndex, int towerTypeIndex, int x, int y) {
+    if (!rec) return;
+    ReplayEvent event = {
+        .tick = tick, .type = REPLAY_EVENT_PLACE_TOWER,
+        .playerIndex = (Sint8)playerIndex, .towerTypeIndex = (Uint8)towerTypeIndex,
+        .x = (Sint16)x, .y = (Sint16)y
+    };
+    push_event(rec, &event);
+}
+
+void replay_record_step(ReplayRecorder *rec, Uint32 tick, const GameState *gameState) {
+    if (!rec || tick == 0) return;
+    rec->lastTick = tick;
+    if (tick - rec->spanStart >= REPLAY_KEYFRAME_INTERVAL) {
+        flush_events(rec);
+        write_keyframe(rec, gameState, tick);
+    }
+}
+
+void replay_recorder_close(ReplayRecorder *rec) {
+    if (!rec) return;
+    flush_events(rec);
+    ReplayTrailer trailer = { rec->offset, rec->lastTick, REPLAY_MAGIC };
+    write_chunk(rec, REPLAY_CHUNK_INDEX, rec->lastTick, rec->index, (size_t)rec->numKeyframes * sizeof(ReplayIndexEntry));
+    fwrite(&trailer, sizeof trailer, 1, rec->file);
+    bool ok = fclose(rec->file) == 0 && !rec->outOfMemory;
+    printf("Replay %s: %d keyframes, ticks up to %u, %lu bytes.\n", ok ? "saved" : "saved INCOMPLETE",
+           rec->numKeyframes, (unsigned)rec->lastTick, (unsigned long)(rec->offset + sizeof trailer));
+    free(rec->events);
+    free(rec->index);
+    free(rec);
+}
+
+// --- Playback ---
+
+// Intern representation
+struct Replay {
+    Uint8 *data;            // Whole file
+    size_t size;
+    ReplayIndexEntry *index;
+    int numKeyframes;
+    Uint32 lastTick;
+    float stepDt;           // 1 / tickRate of the recording
+};
+
+// Chunk at offset, NULL if it does not fit in the file
+static const ReplayChunkHeader *chunk_at(const Replay *replay, size_t offset) {
+    if (offset > replay->size || replay->size - offset < sizeof(ReplayChunkHeader)) return NULL;
+    const ReplayChunkHeader *chunk = (const ReplayChunkHeader *)(replay->data + offset);
+    if (chunk->size > replay->size - offset - sizeof *chunk) return NULL;
+    return chunk;
+}
+
+static bool read_index(Replay *replay) {
+    if (replay->size < sizeof(ReplayFileHeader) + sizeof(ReplayTrailer)) return false;
+    ReplayTrailer trailer;
+    memcpy(&trailer, replay->data + replay->size - sizeof trailer, sizeof trailer);
+    const ReplayChunkHeader *chunk = trailer.magic == REPLAY_MAGIC ? chunk_at(replay, trailer.indexOffset) : NULL;
+    if (!chunk || chunk->type != REPLAY_CHUNK_INDEX || chunk->size % sizeof(ReplayIndexEntry) != 0) return false;
+    int count = (int)(chunk->size / sizeof(ReplayIndexEntry));
+    replay->index = count > 0 ? malloc(chunk->size) : NULL;
+    if (!replay->index) return false;
+    memcpy(replay->index, chunk + 1, chunk->size);
+    for (int i = 0; i < count; ++i) {
+        const ReplayChunkHeader *key = chunk_at(replay, replay->index[i].offset);
+        if (!key || key->type != REPLAY_CHUNK_KEYFRAME || key->tick != replay->index[i].tick) return false;
+    }
+    replay->numKeyframes = count;
+    replay->lastTick = trailer.lastTick;
+    return true;
+}
+
+// Recording that was never closed: walk the chunks, up to the last keyframe
+static bool scan_index(Replay *replay) {
+    free(replay->index);
+    replay->index = NULL;
+    replay->numKeyframes = 0;
+    int capacity = 0;
+    size_t offset = sizeof(ReplayFileHeader);
+    const ReplayChunkHeader *chunk;
+    while ((chunk = chunk_at(replay, offset)) != NULL) {
+        if (chunk->type == REPLAY_CHUNK_KEYFRAME) {
+            if (!grow((void **)&replay->index, replay->numKeyframes, &capacity, sizeof(ReplayIndexEntry))) return false;
+            replay->index[replay->numKeyframes++] = (ReplayIndexEntry){ chunk->tick, (Uint32)offset };
+            replay->lastTick = chunk->tick;
+        }
+        offset += sizeof *chunk + chunk->size;
+    }
+    printf("Replay was not closed, %d keyframes recovered.\n", replay->numKeyframes);
+    return replay->numKeyframes > 0;
+}
+
+Replay *replay_open(const char *path) {
+    FILE *f = path ? fopen(path, "rb") : NULL;
+    if (!f) return NULL;
+    Replay *replay = calloc(1, sizeof *replay);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (replay && size > 0) replay->data = malloc((size_t)size);
+    bool ok = replay && replay->data && fread(replay->data, 1, (size_t)size, f) == (size_t)size;
+    fclose(f);
+    if (!ok) {
+        printf("Failed to read replay '%s'\n", path);
+        replay_close(replay);
+        return NULL;
+    }
+    replay->size = (size_t)size;
+
+    ReplayFileHeader hdr = {0};
+    if (replay->size >= sizeof hdr) memcpy(&hdr, replay->data, sizeof hdr);
+    if (hdr.magic != REPLAY_MAGIC || hdr.version != REPLAY_VERSION || hdr.tickRate == 0) {
+        printf("'%s' is not a replay or from another version.\n", path);
+        replay_close(replay);
+        return NULL;
+    }
+    replay->stepDt = 1.0f / (float)hdr.tickRate;
+    if (!read_index(replay) && !scan_index(replay)) {
+        printf("Replay '%s' holds no keyframe.\n", path);
+        replay_close(replay);
+        return NULL;
+    }
+    return replay;
+}
+
+void replay_close(Replay *replay) {
+    if (!replay) return;
+    free(replay->index);
+    free(replay->data);
+    free(replay);
+}
+
+Uint32 replay_first_tick(const Replay *replay) {
+    return replay ? replay->index[0].tick : 0;
+}
+
+Uint32 replay_last_tick(const Replay *replay) {
+    return replay ? replay->lastTick : 0;
+}
+
+int replay_num_keyframes(const Replay *replay) {
+    return replay ? replay->numKeyframes : 0;
+}
+
+static bool restore_keyframe(const Replay *replay, int k, GameState *out) {
+    const ReplayChunkHeader *chunk = chunk_at(replay, replay->index[k].offset);
+    Uint32 tick = 0;
+    return chunk && savestate_decode((const Uint8 *)(chunk + 1), chunk->size, out, &tick) && tick == chunk->tick;
+}
+
+// Keyframe k, then simulated up to target (< the next keyframe)
+static bool run_span(const Replay *replay, int k, Uint32 target, GameState *out, GameResources *resources) {
+    if (!restore_keyframe(replay, k, out)) return false;
+    const ReplayChunkHeader *keyframe = chunk_at(replay, replay->index[k].offset);
+    const ReplayChunkHeader *chunk = chunk_at(replay, replay->index[k].offset + sizeof *keyframe + keyframe->size);
+    const ReplayEvent *events = NULL;
+    int numEvents = 0;
+    if (chunk && chunk->type == REPLAY_CHUNK_EVENTS && chunk->tick == keyframe->tick) {
+        events = (const ReplayEvent *)(chunk + 1);
+        numEvents = (int)(chunk->size / sizeof(ReplayEvent));
+    }
+
+    const Audio silent = {0};
+    int e = 0;
+    for (Uint32 t = keyframe->tick; t < target; ++t) {
+        for (; e < numEvents && events[e].tick == t; ++e) {
+            if (events[e].type == REPLAY_EVENT_PLACE_TOWER) {
+                place_tower(out, resources, events[e].towerTypeIndex, events[e].x, events[e].y, events[e].playerIndex);
+            }
+        }
+        game_state_step(out, resources, &silent, replay->stepDt);
+    }
+    return true;
+}
+
+bool replay_seek(const Replay *replay, Uint32 tick, GameState *out, GameResources *resources) {
+    if (!replay || !out || !resources) return false;
+    if (tick < replay->index[0].tick) tick = replay->index[0].tick;
+    if (tick > replay->lastTick) tick = replay->lastTick;
+    // Last keyframe at or before tick
+    int lo = 0, hi = replay->numKeyframes - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (replay->index[mid].tick <= tick) lo = mid;
+        else hi = mid - 1;
+    }
+    return run_span(replay, lo, tick, out, resources);
+}
+
+bool replay_verify(const Replay *replay, GameResources *resources, char *report, size_t cap) {
+    if (!replay || !resources || !report || cap == 0) return false;
+    report[0] = '\0';
+    GameState *simulated = calloc(1, sizeof *simulated);
+    GameState *recorded = calloc(1, sizeof *recorded);
+    bool ok = simulated && recorded;
+    for (int k = 0; ok && k + 1 < replay->numKeyframes; ++k) {
+        Uint32 tick = replay->index[k + 1].tick;
+        char field[160];
+        if (!run_span(replay, k, tick, simulated, resources) || !restore_keyframe(replay, k + 1, recorded)) {
+            snprintf(report, cap, "keyframe %d could not be restored", k);
+            ok = false;
+        } else if (state_hash_diff(recorded, simulated, field, sizeof field)) {
+            snprintf(report, cap, "tick %u (from keyframe at %u): %s (recorded vs simulated)",
+                     (unsigned)tick, (unsigned)replay->index[k].tick, field);
+            ok = false;
+        }
+    }
+    free(simulated);
+    free(recorded);
+    return ok;
+}
@@ -0,0 +1,201 @@
+// savestate.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "savestate.h"
+
+#define SAVESTATE_TAIL_OFFSET offsetof(GameState, team_money)
+#define SAVESTATE_TAIL_SIZE (sizeof(GameState) - SAVESTATE_TAIL_OFFSET)
+#define SAVESTATE_PATH_MAX 256
+
+size_t savestate_encode(const GameState *gameState, Uint32 tick, Uint8 *buf, size_t cap) {
+    if (!gameState || !buf) return 0;
+    SaveStateHeader hdr = {
+        .magic          = SAVESTATE_MAGIC,
+        .version        = SAVESTATE_VERSION,
+        .tick           = tick,
+        .stateHash      = state_hash(gameState),
+        .nextEntityId   = gameState->nextEntityId,
+        .numEnemies     = (Uint16)gameState->numEnemiesActive,
+        .numBirds       = (Uint16)gameState->numPlacedBirds,
+        .numProjectiles = (Uint16)gameState->numProjectiles,
+        .enemySize      = (Uint16)sizeof(Enemy),
+        .birdSize       = (Uint16)sizeof(Bird),
+        .projectileSize = (Uint16)sizeof(Projectile),
+        .tailSize       = (Uint32)SAVESTATE_TAIL_SIZE
+    };
+    size_t size = sizeof hdr + SAVESTATE_TAIL_SIZE
+                + hdr.numEnemies * sizeof(Enemy)
+                + hdr.numBirds * sizeof(Bird)
+                + hdr.numProjectiles * sizeof(Projectile);
+    if (cap < size) return 0;
+
+    Uint8 *p = buf;
+    memcpy(p, &hdr, sizeof hdr);                                         p += sizeof hdr;
+    memcpy(p, (const Uint8 *)gameState + SAVESTATE_TAIL_OFFSET, SAVESTATE_TAIL_SIZE); p += SAVESTATE_TAIL_SIZE;
+    memcpy(p, gameState->enemies, hdr.numEnemies * sizeof(Enemy));       p += hdr.numEnemies * sizeof(Enemy);
+    memcpy(p, gameState->placedBirds, hdr.numBirds * sizeof(Bird));     p += hdr.numBirds * sizeof(Bird);
+    memcpy(p, gameState->projectiles, hdr.numProjectiles * sizeof(Projectile));
+    return size;
+}
+
+bool savestate_decode(const Uint8 *buf, size_t len, GameState *gameState, Uint32 *tick) {
+    if (!buf || !gameState || len < sizeof(SaveStateHeader)) return false;
+    SaveStateHeader hdr;
+    memcpy(&hdr, buf, sizeof hdr);
+    if (hdr.magic != SAVESTATE_MAGIC || hdr.version != SAVESTATE_VERSION
+        || hdr.enemySize != sizeof(Enemy) || hdr.birdSize != sizeof(Bird)
+        || hdr.projectileSize != sizeof(Projectile) || hdr.tailSize != SAVESTATE_TAIL_SIZE) {
+        printf("Save state is from another version, ignoring it.\n");
+        return false;
+    }
+    if (hdr.numEnemies > MAX_ENEMIES || hdr.numBirds > MAX_PLACED_BIRDS || hdr.numProjectiles > MAX_PROJECTILES
+        || len < sizeof hdr + SAVESTATE_TAIL_SIZE + hdr.numEnemies * sizeof(Enemy)
+                 + hdr.numBirds * sizeof(Bird) + hdr.numProjectiles * sizeof(Projectile)) {
+        printf("Save state is cut short or corrupt.\n");
+        return false;
+    }
+
+    // Restored beside the caller's state, which is only replaced if the checksum matches
+    GameState *restored = calloc(1, sizeof *restored);
+    if (!restored) return false;
+    const Uint8 *p = buf + sizeof hdr;
+    memcpy((Uint8 *)restored + SAVESTATE_TAIL_OFFSET, p, SAVESTATE_TAIL_SIZE); p += SAVESTATE_TAIL_SIZE;
+    memcpy(restored->enemies, p, hdr.numEnemies * sizeof(Enemy));             p += hdr.numEnemies * sizeof(Enemy);
+    memcpy(restored->placedBirds, p, hdr.numBirds * sizeof(Bird));            p += hdr.numBirds * sizeof(Bird);
+    memcpy(restored->projectiles, p, hdr.numProjectiles * sizeof(Projectile));
+    restored->numEnemiesActive = hdr.numEnemies;
+    restored->numPlacedBirds   = hdr.numBirds;
+    restored->numProjectiles   = hdr.numProjectiles;
+    restored->nextEntityId     = hdr.nextEntityId;
+    restored->towerVersion     = gameState->towerVersion + 1; // Towers changed, rebake render caches
+
+    bool ok = state_hash(restored) == hdr.stateHash;
+    if (ok) {
+        *gameState = *restored;
+        if (tick) *tick = hdr.tick;
+    } else {
+        printf("Save state checksum mismatch, ignoring it.\n");
+    }
+    free(restored);
+    return ok;
+}
+
+// buf holds at least SAVESTATE_MAX_SIZE bytes
+static bool write_file(const char *path, const GameState *gameState, Uint32 tick, Uint8 *buf) {
+    char tmpPath[SAVESTATE_PATH_MAX + 4];
+    size_t size = savestate_encode(gameState, tick, buf, SAVESTATE_MAX_SIZE);
+    if (!path || size == 0 || strlen(path) >= SAVESTATE_PATH_MAX) return false;
+
+    // Written beside the target and renamed over it, a crash never leaves half a file
+    snprintf(tmpPath, sizeof tmpPath, "%s.tmp", path);
+    FILE *f = fopen(tmpPath, "wb");
+    if (!f) {
+        perror(tmpPath);
+        return false;
+    }
+    bool ok = fwrite(buf, 1, size, f) == size;
+    if (fclose(f) != 0) ok = false;
+#ifdef _WIN32
+    if (ok) remove(path); // rename does not replace on Windows
+#endif
+    if (!ok || rename(tmpPath, path) != 0) {
+        printf("Failed to write save state '%s'\n", path);
+        remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+bool savestate_save(const char *path, const GameState *gameState, Uint32 tick) {
+    Uint8 *buf = malloc(SAVESTATE_MAX_SIZE);
+    bool ok = buf && write_file(path, gameState, tick, buf);
+    free(buf);
+    return ok;
+}
+
+bool savestate_load(const char *path, GameState *gameState, Uint32 *tick) {
+    FILE *f = path ? fopen(path, "rb") : NULL;
+    if (!f) return false;
+    Uint8 *buf = malloc(SAVESTATE_MAX_SIZE);
+    size_t len = buf ? fread(buf, 1, SAVESTATE_MAX_SIZE, f) : 0;
+    fclose(f);
+    bool ok = buf && savestate_decode(buf, len, gameState, tick);
+    free(buf);
+    return ok;
+}
+
+// Intern representation
+struct SaveStateWriter {
+    SDL_Thread *thread;
+    SDL_mutex *lock;
+    SDL_cond *wake;
+    bool pending;           // state/path/tick hold a submission not yet taken
+    bool quit;
+    GameState state;        // Latest submission
+    Uint32 tick;
+    char path[SAVESTATE_PATH_MAX];
+    GameState writing;      // Writer thread's copy, encoded without the lock
+    Uint8 buf[SAVESTATE_MAX_SIZE];
+};
+
+static int writer_main(void *data) {
+    SaveStateWriter *writer = data;
+    char path[SAVESTATE_PATH_MAX];
+    SDL_LockMutex(writer->lock);
+    while (true) {
+        while (!writer->pending && !writer->quit) SDL_CondWait(writer->wake, writer->lock);
+        if (!writer->pending) break; // Quit with nothing left to write
+        writer->writing = writer->state;
+        Uint32 tick = writer->tick;
+        memcpy(path, writer->path, sizeof path);
+        writer->pending = false;
+        SDL_UnlockMutex(writer->lock);
+
+        write_file(path, &writer->writing, tick, writer->buf);
+
+        SDL_LockMutex(writer->lock);
+    }
+    SDL_UnlockMutex(writer->lock);
+    return 0;
+}
+
+SaveStateWriter *savestate_writer_create(void) {
+    SaveStateWriter *writer = calloc(1, sizeof *writer);
+    if (!writer) return NULL;
+    writer->lock = SDL_CreateMutex();
+    writer->wake = SDL_CreateCond();
+    writer->thread = (writer->lock && writer->wake) ? SDL_CreateThread(writer_main, "SaveStateWriter", writer) : NULL;
+    if (!writer->thread) {
+        printf("Save state writer: failed to start: %s\n", SDL_GetError());
+        if (writer->wake) SDL_DestroyCond(writer->wake);
+        if (writer->lock) SDL_DestroyMutex(writer->lock);
+        free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+void savestate_writer_destroy(SaveStateWriter *writer) {
+    if (!writer) return;
+    SDL_LockMutex(writer->lock);
+    writer->quit = true;
+    SDL_CondSignal(writer->wake);
+    SDL_UnlockMutex(writer->lock);
+    SDL_WaitThread(writer->thread, NULL);
+    SDL_DestroyCond(writer->wake);
+    SDL_DestroyMutex(writer->lock);
+    free(writer);
+}
+
+bool savestate_writer_submit(SaveStateWriter *writer, const char *path, const GameState *gameState, Uint32 tick) {
+    if (!writer || !path || !gameState || strlen(path) >= SAVESTATE_PATH_MAX) return false;
+    SDL_LockMutex(writer->lock);
+    writer->state = *gameState;
+    writer->tick = tick;
+    snprintf(writer->path, sizeof writer->path, "%s", path);
+    writer->pending = true;
+    SDL_CondSignal(writer->wake);
+    SDL_UnlockMutex(writer->lock);
+    return true;
+}
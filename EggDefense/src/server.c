@@ -10,6 +10,12 @@
 #include "money_adt.h"
 
 #include "engine.h"
+#include "fragment.h"
+#include "locallink.h"
+#include "snapshot.h"
+#include "spectate.h"
+#include "savestate.h"
+#include "replay.h"
 #include "paths.h"
 #include "defs.h"  // för WINDOW_WIDTH
 
@@ -22,15 +28,51 @@ static int find_client_index(ServerInstance* server, IPaddress address);
 static int add_client(ServerInstance* server, IPaddress address);
 static void broadcast_packet(ServerInstance* server, ServerPacketData* data);
 static void send_packet_to_client(ServerInstance* server, int clientIndex, ServerPacketData* data);
+static void send_snapshot_to_client(ServerInstance* server, int clientIndex, ServerCommandType command, const GameStateSnapshot* snapshot);
+static bool send_to_address(ServerInstance* server, IPaddress address, const void* data, int len);
 static void prepare_snapshot(GameState* current_state, GameStateSnapshot* snapshot);
 static void update_server_game_state(ServerInstance* server, float dt);
 static void render_debug_view(ServerInstance* server);
+static void update_client_stats(ServerInstance* server, Uint32 now);
+static void toggle_stats_csv(ServerInstance* server);
+static void handle_spectator_packet(ServerInstance* server, UDPpacket* packet, const ClientPacketData* cd);
+static void send_spectator_frames(ServerInstance* server, const GameStateSnapshot* snapshot);
+static void expire_spectators(ServerInstance* server, Uint32 now);
+static bool begin_match(ServerInstance* server);
+static void print_match_memory(const ServerInstance* server);
+
+// Set by stop_server from the host's main thread
+static SDL_atomic_t stopRequested;
+
+void stop_server(void) {
+    SDL_AtomicSet(&stopRequested, 1);
+}
 
 // --- Public Entry Point ---
-int run_server(void) {
+int run_server(const GameResources* shared) {
     ServerInstance server = {0};
     srand((unsigned int)time(NULL));
     server.is_running = true;
+    SDL_AtomicSet(&stopRequested, 0);
+
+    if (shared) {
+        // Host mode: SDL, the window and all assets belong to the app on the
+        // main thread. Only the gameplay data is shared, no SDL init, no
+        // window, no menu: the host's client has its own.
+        server.hosted = true;
+        share_gameplay_resources(&server.resources, shared);
+        printf("Server started in host mode (headless).\n");
+        if (!initialize_server(&server)) {
+            printf("Server network/state initialization failed.\n");
+            shutdown_server(&server);
+            return 1;
+        }
+        run_server_loop(&server);
+        shutdown_server(&server);
+        printf("Server shut down normally.\n");
+        return 0;
+    }
+
     // SDL init
     if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_AUDIO) != 0) {
         printf("SDL_Init Error: %s\n", SDL_GetError());
@@ -49,6 +91,8 @@ int run_server(void) {
         SDL_Quit();
         return 1;
     }
+    // The debug view must not pace the simulation through vsync
+    SDL_RenderSetVSync(server.debugRenderer, 0);
     if (!load_resources(server.debugRenderer, &server.resources, &server.audio)) {
         fprintf(stderr, "Server critical resource loading failed.\n");
         cleanup_sdl(server.debugWindow, server.debugRenderer);
@@ -101,55 +145,126 @@ int run_server(void) {
 static bool initialize_server(ServerInstance* server) {
     server->num_clients = 0;
     server->lastTickTime = SDL_GetTicks();
-    initialize_game_state(&server->gameState, &server->resources);
+    // Save states: periodic checkpoints of the running match, and resuming
+    // from one (migrating a match, benchmarks starting mid-game)
+    server->resumePath = getenv("EGG_LOAD_STATE");
+    server->replayPath = getenv("EGG_REPLAY");
+    server->checkpointPath = getenv("EGG_CHECKPOINT");
+    if (server->checkpointPath && *server->checkpointPath) {
+        server->checkpointWriter = savestate_writer_create();
+        if (server->checkpointWriter) printf("Checkpointing the match to '%s' every %d ticks.\n",
+                                             server->checkpointPath, SAVESTATE_CHECKPOINT_INTERVAL);
+    }
+    server->matchArena = arena_create(MATCH_ARENA_SIZE);
+    if (!server->matchArena || !begin_match(server)) {
+        printf("Failed to set up the match arena\n");
+        return false;
+    }
 
-    printf("Opening UDP socket on port %d...\n", SERVER_PORT);
-    server->socket = SDLNet_UDP_Open(SERVER_PORT);
-    if (!server->socket) {
-        printf("SDLNet_UDP_Open Error: %s\n", SDLNet_GetError());
+    // EGG_SERVER_PORT lets several servers share a machine (see loadgen -m)
+    int port = SERVER_PORT;
+    const char* portEnv = getenv("EGG_SERVER_PORT");
+    if (portEnv && atoi(portEnv) > 0 && atoi(portEnv) < 65536) port = atoi(portEnv);
+    printf("Opening UDP socket on port %d...\n", port);
+    server->transport = transport_open((Uint16)port);
+    if (!server->transport) {
+        printf("Failed to open server transport on port %d\n", port);
         return false;
     }
-    server->packet_in  = SDLNet_AllocPacket(PACKET_BUFFER_SIZE);
-    server->packet_out = SDLNet_AllocPacket(PACKET_BUFFER_SIZE);
-    if (!server->packet_in || !server->packet_out) {
+    printf("Server transport backend: %s\n", transport_backend_name(server->transport));
+    NetConditionerConfig nc;
+    if (netcond_config_from_env(&nc) && transport_set_conditioner(server->transport, &nc)) {
+        printf("Network conditioner on: delay %u+%u ms, loss %.1f%%, dup %.1f%%, reorder %.1f%%, seed %u\n",
+               (unsigned)nc.delayMs, (unsigned)nc.jitterMs, nc.lossPercent,
+               nc.duplicatePercent, nc.reorderPercent, (unsigned)nc.seed);
+    }
+    server->packet_in = SDLNet_AllocPacket(PACKET_BUFFER_SIZE);
+    if (!server->packet_in) {
         printf("SDLNet_AllocPacket Error: %s\n", SDLNet_GetError());
-        if (server->packet_in)  SDLNet_FreePacket(server->packet_in);
-        if (server->packet_out) SDLNet_FreePacket(server->packet_out);
-        if (server->socket)     SDLNet_UDP_Close(server->socket);
-        server->socket = NULL;
+        transport_close(server->transport);
+        server->transport = NULL;
+        return false;
+    }
+    server->tickLoop = tickloop_create(server->transport, GAME_TICK_RATE);
+    if (!server->tickLoop) {
+        printf("Failed to create server tick loop\n");
         return false;
     }
+    tickloop_set_idle(server->tickLoop, true); // Lobby until everyone is ready
+    printf("Server tick loop: %s\n", tickloop_backend_name(server->tickLoop));
+    server->spectatorFeed = spectator_feed_create();
+    if (!server->spectatorFeed) {
+        printf("Spectators disabled (feed allocation failed).\n");
+    }
 
     printf("Server network initialized. Waiting for players...\n");
     return true;
 }
 
+// Hands out a new match's memory: the arena is emptied in one step and the
+// match blocks are carved from it again
+static bool begin_match(ServerInstance* server) {
+    arena_reset(server->matchArena);
+    server->gameState = arena_alloc(server->matchArena, sizeof(GameState));
+    server->snapshotScratch = arena_alloc(server->matchArena, sizeof(GameStateSnapshot));
+    if (!server->gameState || !server->snapshotScratch) return false;
+    initialize_game_state(server->gameState, &server->resources);
+    server->matchTick = 0;
+    if (server->resumePath && *server->resumePath) {
+        Uint32 start = SDL_GetTicks();
+        if (savestate_load(server->resumePath, server->gameState, &server->matchTick)) {
+            printf("Match resumes from '%s': tick %u, wave %d (loaded in %u ms)\n", server->resumePath,
+                   (unsigned)server->matchTick, server->gameState->currentWave, (unsigned)(SDL_GetTicks() - start));
+        } else {
+            printf("Could not load save state '%s', starting a new match.\n", server->resumePath);
+        }
+        server->resumePath = NULL; // Rematches start fresh
+    }
+    server->stateHash = state_hash(server->gameState);
+    return true;
+}
+
+static void print_match_memory(const ServerInstance* server) {
+    ArenaStats st = arena_stats(server->matchArena);
+    printf("Match memory: %lu bytes in %u allocations, peak %lu of %lu\n",
+           (unsigned long)st.used, (unsigned)st.allocations, (unsigned long)st.peak, (unsigned long)st.capacity);
+}
+
 // --- Main Server Loop ---
+// Sleeps in tickloop_wait until a datagram arrives or a tick is due. While
+// no match runs the loop only wakes every SERVER_IDLE_TICK_MS.
 static void run_server_loop(ServerInstance* server) {
     bool game_started = false;
-    Uint32 time_per_tick = 1000 / GAME_TICK_RATE;
 
     while (server->is_running) {
+        int ticksDue = tickloop_wait(server->tickLoop);
         Uint32 currentTime = SDL_GetTicks();
-        Uint32 elapsedTime = currentTime - server->lastTickTime;
         SDL_Event event;
 
-        // Quit handling
-        while (SDL_PollEvent(&event)) {
+        // Quit handling. Hosted, the events belong to the app's window.
+        if (SDL_AtomicGet(&stopRequested)) server->is_running = false;
+        while (!server->hosted && SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) server->is_running = false;
             if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)
                 server->is_running = false;
+            if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F5)
+                toggle_stats_csv(server);
         }
         if (!server->is_running) break;
 
         // Receive incoming client packets
-        while (SDLNet_UDP_Recv(server->socket, server->packet_in) > 0) {
+        while (transport_recv(server->transport, server->packet_in) > 0) {
+            handle_client_packet(server, server->packet_in);
+        }
+        // Host player's commands arrive in-process
+        while (locallink_server_recv(server->packet_in) > 0) {
             handle_client_packet(server, server->packet_in);
         }
 
-        if (elapsedTime >= time_per_tick) {
-            float dt = (float)elapsedTime / 1000.0f;
-            if (dt > 0.1f) dt = 0.1f;
+        if (ticksDue > 0) {
+            // Fixed step: one simulation tick of 1/GAME_TICK_RATE per passed
+            // deadline, so matchTick always counts ticks of game time
+            const float dt = 1.0f / (float)GAME_TICK_RATE;
             server->lastTickTime = currentTime;
 
             if (!game_started) {
@@ -164,9 +279,29 @@ static void run_server_loop(ServerInstance* server) {
                 }
                 if (allReady) {
                     printf("All %d players ready! Starting game.\n", MAX_PLAYERS);
+                    if (server->gameState->gameOver) {
+                        // Rematch: everyone readied again after a game over.
+                        // The last match's arena memory is reused as a whole.
+                        if (!begin_match(server)) {
+                            server->is_running = false;
+                            break;
+                        }
+                        spectator_feed_force_keyframe(server->spectatorFeed);
+                        printf("Rematch started.\n");
+                    }
                     game_started = true;
-                    server->gameState.spawnTimer = 0.0f;
-                    //server->gameState.moneyTimer = 0.0f;
+                    tickloop_set_idle(server->tickLoop, false);
+                    if (server->matchTick == 0) server->gameState->spawnTimer = 0.0f; // Not on a resumed match
+                    server->matchesStarted++;
+                    if (server->replayPath && *server->replayPath) {
+                        // replay.egr, replay.egr.2, ... for rematches
+                        char path[256];
+                        if (server->matchesStarted == 1) snprintf(path, sizeof path, "%s", server->replayPath);
+                        else snprintf(path, sizeof path, "%s.%d", server->replayPath, server->matchesStarted);
+                        server->replay = replay_recorder_open(path, server->gameState, server->matchTick);
+                        if (server->replay) printf("Recording replay to '%s'.\n", path);
+                    }
+                    //server->gameState->moneyTimer = 0.0f;
                     ServerPacketData sp = {.command = SERVER_CMD_GAME_START};
                     broadcast_packet(server, &sp);
                 } else {
@@ -183,75 +318,78 @@ static void run_server_loop(ServerInstance* server) {
             }
 
             if (game_started) {
-                // 1) Uppdatera game state
-                update_server_game_state(server, dt);
-
-                // 2) Kolla om spelet tog slut den här tick: 
-                if (server->gameState.gameOver) {
-                    printf("Server detected Game Over. Winner: %d\n", server->gameState.winner);
-                    // Skicka GAME_OVER till alla klienter
-                    for (int ci = 0; ci < server->num_clients; ++ci) {
-                        ServerPacketData op = {.command = SERVER_CMD_GAME_OVER};
-                        prepare_snapshot(&server->gameState, &op.snapshot);
-                        Team team = (ci == 0 || ci == 2) ? TEAM_LEFT : TEAM_RIGHT;
-                        op.snapshot.money = money_manager_get_balance(server->gameState.team_money[team]);
-                        send_packet_to_client(server, ci, &op);
+                // 1) Uppdatera game state, en tick per missad deadline. After a
+                // long stall only SERVER_MAX_CATCHUP_TICKS are caught up.
+                int steps = (ticksDue < SERVER_MAX_CATCHUP_TICKS) ? ticksDue : SERVER_MAX_CATCHUP_TICKS;
+                for (int step = 0; step < steps && !server->gameState->gameOver; ++step) {
+                    update_server_game_state(server, dt);
+                    server->matchTick++;
+                    server->stateHash = state_hash(server->gameState);
+                    replay_record_step(server->replay, server->matchTick, server->gameState);
+                    if (server->checkpointWriter && server->matchTick % SAVESTATE_CHECKPOINT_INTERVAL == 0) {
+                        savestate_writer_submit(server->checkpointWriter, server->checkpointPath,
+                                                server->gameState, server->matchTick); // Copy only, written on its thread
                     }
-                    // Avmarkera så att vi inte skickar fler updates
-                    game_started = false;
                 }
-                else {
-                    // 3) Om spelet fortfarande pågår, skicka STATE_UPDATE
-                    for (int ci = 0; ci < server->num_clients; ++ci) {
-                        ServerPacketData stp = {.command = SERVER_CMD_STATE_UPDATE};
-                        prepare_snapshot(&server->gameState, &stp.snapshot);
-                        Team team = (ci == 0 || ci == 2) ? TEAM_LEFT : TEAM_RIGHT;
-                        stp.snapshot.money = money_manager_get_balance(server->gameState.team_money[team]);
-                        send_packet_to_client(server, ci, &stp);
-                    }
+
+                // 2) Skicka GAME_OVER om spelet tog slut den här tick, annars STATE_UPDATE.
+                // The snapshot is the same for everyone except team money.
+                // With a host player it is built straight into the local link's
+                // buffer, which the host client then reads without a copy.
+                int localClient = -1;
+                for (int ci = 0; ci < server->num_clients; ++ci) {
+                    if (locallink_is_local_address(server->clients[ci].address)) localClient = ci;
+                }
+                GameStateSnapshot* ss = (localClient != -1) ? locallink_snapshot_begin() : server->snapshotScratch;
+                prepare_snapshot(server->gameState, ss);
+                ServerCommandType cmd = server->gameState->gameOver ? SERVER_CMD_GAME_OVER : SERVER_CMD_STATE_UPDATE;
+                if (server->gameState->gameOver) {
+                    printf("Server detected Game Over. Winner: %d\n", server->gameState->winner);
+                }
+                for (int ci = 0; ci < server->num_clients; ++ci) {
+                    if (ci == localClient || server->clients[ci].timedOut) continue;
+                    Team team = (ci == 0 || ci == 2) ? TEAM_LEFT : TEAM_RIGHT;
+                    ss->money = money_manager_get_balance(&server->gameState->team_money[team]);
+                    send_snapshot_to_client(server, ci, cmd, ss);
+                }
+                // Spectators: reduced rate, but always the final frame
+                server->tickCount++;
+                if (server->num_spectators > 0 &&
+                    (server->tickCount % SPECTATOR_TICK_DIVISOR == 0 || server->gameState->gameOver)) {
+                    ss->money = 0;
+                    send_spectator_frames(server, ss);
+                }
+                if (localClient != -1) {
+                    Team team = (localClient == 0 || localClient == 2) ? TEAM_LEFT : TEAM_RIGHT;
+                    ss->money = money_manager_get_balance(&server->gameState->team_money[team]);
+                    locallink_snapshot_publish(cmd);
+                }
+                // Avmarkera så att vi inte skickar fler updates. A rematch
+                // starts when every player has sent READY again.
+                if (server->gameState->gameOver) {
+                    printf("Match ended at tick %u, state hash %08x\n",
+                           (unsigned)server->matchTick, (unsigned)server->stateHash);
+                    print_match_memory(server);
+                    replay_recorder_close(server->replay);
+                    server->replay = NULL;
+                    game_started = false;
+                    tickloop_set_idle(server->tickLoop, true);
+                    for (int ci = 0; ci < server->num_clients; ++ci) server->clients[ci].ready = false;
                 }
             }
+            update_client_stats(server, currentTime);
+            expire_spectators(server, currentTime);
             render_debug_view(server);
         }
 
-
-        Uint32 frameTime = SDL_GetTicks() - currentTime;
-        if (frameTime < time_per_tick) SDL_Delay(time_per_tick - frameTime);
-        else SDL_Delay(1);
+        // Everything queued this iteration (replies + snapshots) leaves in one batch
+        transport_flush(server->transport);
     }
 }
 
 // --- Game State Update ---
 static void update_server_game_state(ServerInstance* server, float dt) {
-    GameState* gs        = &server->gameState;
-    GameResources* res   = &server->resources;
-    Audio* audio         = &server->audio;
-
-    for (int t = 0; t < NUM_TEAMS; ++t) {
-    money_manager_update(server->gameState.team_money[t], dt);
-    }
-
-    if (gs->inWaveDelay) {
-        gs->spawnCooldown -= dt;
-        if (gs->spawnCooldown <= 0.0f) {
-            gs->inWaveDelay = false;
-            if (gs->currentWave > 0) {
-                play_sound(audio, audio->levelUpSound);
-            }
-            gs->currentWave++;
-            gs->spawnTimer = ENEMY_SPAWN_INTERVAL;
-        }
-    } else {
-        gs->spawnTimer += dt;
-        if (gs->spawnTimer >= ENEMY_SPAWN_INTERVAL) {
-            gs->spawnTimer -= ENEMY_SPAWN_INTERVAL;
-            spawn_enemy_pair(gs, res);
-        }
-    }
-
-    update_enemies(gs, dt);
-    update_towers(gs, audio, dt, res);
-    update_projectiles(gs, dt);
+    game_state_step(server->gameState, &server->resources, &server->audio, dt);
 }
 
 // --- Networking Helpers ---
@@ -272,22 +410,31 @@ static int add_client(ServerInstance* server, IPaddress address) {
     server->clients[newIndex].address        = address;
     server->clients[newIndex].ready          = false;
     server->clients[newIndex].lastPacketTime = SDL_GetTicks();
+    server->clients[newIndex].timedOut       = false;
+    netstats_reset(&server->clients[newIndex].stats, SDL_GetTicks());
     return newIndex;
 }
 
 static void handle_client_packet(ServerInstance* server, UDPpacket* packet) {
     if ((size_t)packet->len < sizeof(ClientCommandType)) return;
-    ClientPacketData cd;
+    ClientPacketData cd = {0};
     size_t copySize = ((size_t)packet->len < sizeof(ClientPacketData))
                       ? (size_t)packet->len
                       : sizeof(ClientPacketData);
     memcpy(&cd, packet->data, copySize);
 
+    if (cd.command == CLIENT_CMD_SPECTATE) {
+        handle_spectator_packet(server, packet, &cd);
+        return;
+    }
+
     int ci = find_client_index(server, packet->address);
     if (ci == -1) {
         if (cd.command == CLIENT_CMD_READY) {
             int ni = add_client(server, packet->address);
             if (ni != -1) {
+                netstats_on_receive(&server->clients[ni].stats, packet->len);
+                netstats_on_stamp(&server->clients[ni].stats, &cd.stamp, SDL_GetTicks());
                 printf("Player %d connected: %x:%d\n", ni,
                        packet->address.host, packet->address.port);
                 ServerPacketData ap = {
@@ -306,16 +453,20 @@ static void handle_client_packet(ServerInstance* server, UDPpacket* packet) {
                 printf("Connection rejected (Server Full) for %x:%d\n",
                        packet->address.host, packet->address.port);
                 ServerPacketData rp = {.command = SERVER_CMD_REJECT_FULL};
-                server->packet_out->address = packet->address;
-                server->packet_out->len     = sizeof(ServerCommandType);
-                memcpy(server->packet_out->data, &rp, server->packet_out->len);
-                SDLNet_UDP_Send(server->socket, -1, server->packet_out);
+                send_to_address(server, packet->address, &rp, sizeof(ServerCommandType));
             }
         }
         return;
     }
 
-    server->clients[ci].lastPacketTime = SDL_GetTicks();
+    Uint32 now = SDL_GetTicks();
+    server->clients[ci].lastPacketTime = now;
+    if (server->clients[ci].timedOut) {
+        server->clients[ci].timedOut = false;
+        printf("Player %d is back after a timeout.\n", ci);
+    }
+    netstats_on_receive(&server->clients[ci].stats, packet->len);
+    netstats_on_stamp(&server->clients[ci].stats, &cd.stamp, now);
     if (cd.playerIndex != ci && cd.command != CLIENT_CMD_READY) {
         // Mismatch—ignorera
     }
@@ -334,7 +485,7 @@ static void handle_client_packet(ServerInstance* server, UDPpacket* packet) {
             break;
 
         case CLIENT_CMD_PLACE_TOWER:
-            if (server->gameState.gameOver) break;
+            if (server->gameState->gameOver) break;
 
             // ——— Här infogas lag‐kontrollen ———
             {
@@ -351,12 +502,16 @@ static void handle_client_packet(ServerInstance* server, UDPpacket* packet) {
 
             // Själva placeringen
             {
-                bool placed = place_tower(&server->gameState,
+                bool placed = place_tower(server->gameState,
                                           &server->resources,
                                           cd.towerTypeIndex,
                                           cd.targetX,
                                           cd.targetY,
                                           ci);
+                if (placed) {
+                    replay_record_place_tower(server->replay, server->matchTick, ci,
+                                              cd.towerTypeIndex, cd.targetX, cd.targetY);
+                }
                 ServerPacketData reply = {0};
                 reply.command = placed
                     ? SERVER_CMD_PLACE_TOWER_CONFIRM
@@ -374,32 +529,157 @@ static void handle_client_packet(ServerInstance* server, UDPpacket* packet) {
     }
 }
 
+// Every client gets its own copy since the stamp is per connection
 static void broadcast_packet(ServerInstance* server, ServerPacketData* data) {
-    if (!server->packet_out) return;
-    server->packet_out->len = sizeof(ServerPacketData);
-    memcpy(server->packet_out->data, data, server->packet_out->len);
+    if (!server->transport) return;
     for (int i = 0; i < server->num_clients; ++i) {
-        server->packet_out->address = server->clients[i].address;
-        if (SDLNet_UDP_Send(server->socket, -1, server->packet_out) == 0) {
-            printf("Warn: broadcast send failed to P%d\n", i);
-        }
+        send_packet_to_client(server, i, data);
     }
 }
 
 static void send_packet_to_client(ServerInstance* server,
                                   int ci,
                                   ServerPacketData* data) {
-    if (ci < 0 || ci >= server->num_clients || !server->packet_out) return;
-    server->packet_out->len     = sizeof(ServerPacketData);
-    memcpy(server->packet_out->data, data, server->packet_out->len);
-    server->packet_out->address = server->clients[ci].address;
-    if (SDLNet_UDP_Send(server->socket, -1, server->packet_out) == 0) {
+    if (ci < 0 || ci >= server->num_clients || !server->transport || !data) return;
+    netstats_stamp(&server->clients[ci].stats, &data->stamp, SDL_GetTicks());
+    netstats_on_send(&server->clients[ci].stats, (int)SERVER_PACKET_HEADER_SIZE, 1);
+    if (!send_to_address(server, server->clients[ci].address, data, (int)SERVER_PACKET_HEADER_SIZE)) {
         printf("Warn: send_packet failed to P%d (Cmd %d)\n",
                ci,
                data ? (int)data->command : -1);
     }
 }
 
+// Routes a small message to the host player in-process, everyone else over UDP
+static bool send_to_address(ServerInstance* server, IPaddress address, const void* data, int len) {
+    if (locallink_is_local_address(address)) {
+        return locallink_server_send(data, len);
+    }
+    return transport_send(server->transport, address, data, len);
+}
+
+// Snapshots are encoded compactly and split into MTU-sized fragments.
+// Message layout: [ServerPacketData header][encoded snapshot]
+static void send_snapshot_to_client(ServerInstance* server,
+                                    int ci,
+                                    ServerCommandType command,
+                                    const GameStateSnapshot* snapshot) {
+    if (ci < 0 || ci >= server->num_clients || !server->transport) return;
+    static Uint8 message[SERVER_PACKET_HEADER_SIZE + SNAPSHOT_MAX_ENCODED_SIZE];
+    ServerPacketData header = {.command = command};
+    NetStats* stats = &server->clients[ci].stats;
+    netstats_stamp(stats, &header.stamp, SDL_GetTicks());
+    memcpy(message, &header, SERVER_PACKET_HEADER_SIZE);
+    int len = snapshot_encode(snapshot, message + SERVER_PACKET_HEADER_SIZE, SNAPSHOT_MAX_ENCODED_SIZE);
+    if (len <= 0) return;
+    int total = (int)SERVER_PACKET_HEADER_SIZE + len;
+    int fragments = fragment_send(server->transport, server->clients[ci].address,
+                                  server->nextMessageId++, message, total);
+    if (fragments == 0) {
+        printf("Warn: snapshot send failed to P%d (Cmd %d)\n", ci, (int)command);
+        return;
+    }
+    netstats_on_send(stats, total + fragments * (int)sizeof(FragmentHeader), fragments);
+    netstats_on_snapshot(stats, total);
+}
+
+// Rolls per-second rates, flags silent clients and appends CSV rows
+static void update_client_stats(ServerInstance* server, Uint32 now) {
+    for (int i = 0; i < server->num_clients; ++i) {
+        ClientInfo* c = &server->clients[i];
+        netstats_update(&c->stats, now);
+        if (!c->timedOut && now - c->lastPacketTime > SERVER_CLIENT_TIMEOUT) {
+            c->timedOut = true;
+            printf("Player %d timed out (no packets for %u ms).\n", i, (unsigned)(now - c->lastPacketTime));
+        }
+    }
+    if (server->statsCsv && now - server->lastStatsCsvTime >= NETSTATS_CSV_INTERVAL) {
+        server->lastStatsCsvTime = now;
+        for (int i = 0; i < server->num_clients; ++i) {
+            char name[16];
+            snprintf(name, sizeof name, "P%d", i);
+            netstats_write_csv_row(server->statsCsv, now, name, &server->clients[i].stats);
+        }
+        fflush(server->statsCsv);
+    }
+}
+
+static void toggle_stats_csv(ServerInstance* server) {
+    if (server->statsCsv) {
+        fclose(server->statsCsv);
+        server->statsCsv = NULL;
+        printf("Network stats export stopped.\n");
+        return;
+    }
+    server->statsCsv = fopen("netstats_server.csv", "w");
+    if (!server->statsCsv) {
+        perror("netstats_server.csv");
+        return;
+    }
+    netstats_write_csv_header(server->statsCsv);
+    server->lastStatsCsvTime = 0;
+    printf("Exporting network stats to netstats_server.csv\n");
+}
+
+// --- Spectators ---
+// Viewers never get a player slot. A new one forces a keyframe so it can
+// start decoding right away.
+static void handle_spectator_packet(ServerInstance* server, UDPpacket* packet, const ClientPacketData* cd) {
+    Uint32 now = SDL_GetTicks();
+    SpectatorInfo* sp = NULL;
+    for (int i = 0; i < server->num_spectators; ++i) {
+        if (server->spectators[i].address.host == packet->address.host &&
+            server->spectators[i].address.port == packet->address.port) {
+            sp = &server->spectators[i];
+            break;
+        }
+    }
+    if (!sp) {
+        if (server->num_spectators >= MAX_SPECTATORS || !server->spectatorFeed) {
+            ServerPacketData rp = {.command = SERVER_CMD_REJECT_FULL};
+            send_to_address(server, packet->address, &rp, (int)SERVER_PACKET_HEADER_SIZE);
+            return;
+        }
+        sp = &server->spectators[server->num_spectators++];
+        memset(sp, 0, sizeof *sp);
+        sp->address = packet->address;
+        netstats_reset(&sp->stats, now);
+        spectator_feed_force_keyframe(server->spectatorFeed);
+        printf("Spectator %x:%d joined (%d watching).\n",
+               packet->address.host, packet->address.port, server->num_spectators);
+    }
+    sp->lastPacketTime = now;
+    netstats_on_receive(&sp->stats, packet->len);
+    netstats_on_stamp(&sp->stats, &cd->stamp, now);
+}
+
+// One frame is encoded per spectator tick and sent to every viewer
+static void send_spectator_frames(ServerInstance* server, const GameStateSnapshot* snapshot) {
+    int frameLen = 0;
+    const Uint8* frame = spectator_feed_encode(server->spectatorFeed, snapshot, &frameLen);
+    if (!frame) return;
+    static Uint8 message[SERVER_PACKET_HEADER_SIZE + SPECTATOR_MAX_FRAME_SIZE];
+    memcpy(message + SERVER_PACKET_HEADER_SIZE, frame, (size_t)frameLen);
+    int total = (int)SERVER_PACKET_HEADER_SIZE + frameLen;
+    for (int i = 0; i < server->num_spectators; ++i) {
+        SpectatorInfo* sp = &server->spectators[i];
+        ServerPacketData header = {.command = SERVER_CMD_SPECTATOR_FRAME};
+        netstats_stamp(&sp->stats, &header.stamp, SDL_GetTicks());
+        memcpy(message, &header, SERVER_PACKET_HEADER_SIZE);
+        int fragments = fragment_send(server->transport, sp->address, server->nextMessageId++, message, total);
+        netstats_on_send(&sp->stats, total + fragments * (int)sizeof(FragmentHeader), fragments);
+    }
+}
+
+static void expire_spectators(ServerInstance* server, Uint32 now) {
+    for (int i = server->num_spectators - 1; i >= 0; --i) {
+        if (now - server->spectators[i].lastPacketTime <= SERVER_CLIENT_TIMEOUT) continue;
+        printf("Spectator %x:%d timed out.\n",
+               server->spectators[i].address.host, server->spectators[i].address.port);
+        server->spectators[i] = server->spectators[--server->num_spectators];
+    }
+}
+
 static void prepare_snapshot(GameState* cs, GameStateSnapshot* ss) {
     if (!cs || !ss) return;
     memset(ss, 0, sizeof(GameStateSnapshot));
@@ -408,15 +688,29 @@ static void prepare_snapshot(GameState* cs, GameStateSnapshot* ss) {
     ss->currentWave      = cs->currentWave;
     ss->gameOver         = cs->gameOver;
     ss->winner           = cs->winner;
+    // Enemies furthest along the path go first so they land in the first fragment
+    int order[MAX_ENEMIES];
+    for (int i = 0; i < cs->numEnemiesActive; ++i) {
+        float progress = (float)cs->enemies[i].currentSegment + cs->enemies[i].segmentProgress;
+        int j = i;
+        while (j > 0) {
+            const Enemy *prev = &cs->enemies[order[j - 1]];
+            if ((float)prev->currentSegment + prev->segmentProgress >= progress) break;
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
     ss->numEnemiesActive = cs->numEnemiesActive;
     for (int i = 0; i < cs->numEnemiesActive; ++i) {
-        ss->enemies[i].x     = cs->enemies[i].x;
-        ss->enemies[i].y     = cs->enemies[i].y;
-        ss->enemies[i].angle = cs->enemies[i].angle;
-        ss->enemies[i].type  = cs->enemies[i].type;
-        ss->enemies[i].hp    = cs->enemies[i].hp;
-        ss->enemies[i].active= cs->enemies[i].active;
-        ss->enemies[i].side  = cs->enemies[i].side;
+        const Enemy *e = &cs->enemies[order[i]];
+        ss->enemies[i].x     = e->x;
+        ss->enemies[i].y     = e->y;
+        ss->enemies[i].angle = e->angle;
+        ss->enemies[i].type  = e->type;
+        ss->enemies[i].hp    = e->hp;
+        ss->enemies[i].active= e->active;
+        ss->enemies[i].side  = e->side;
     }
     ss->numPlacedBirds = cs->numPlacedBirds;
     for (int i = 0; i < cs->numPlacedBirds; ++i) {
@@ -440,12 +734,28 @@ static void prepare_snapshot(GameState* cs, GameStateSnapshot* ss) {
 static void shutdown_server(ServerInstance* server) {
     printf("Shutting down server...\n");
     if (!server) return;
-    if (server->packet_in)  SDLNet_FreePacket(server->packet_in);
-    if (server->packet_out) SDLNet_FreePacket(server->packet_out);
-    if (server->socket)     SDLNet_UDP_Close(server->socket);
-    server->packet_in  = NULL;
-    server->packet_out = NULL;
-    server->socket     = NULL;
+    if (server->statsCsv) fclose(server->statsCsv);
+    server->statsCsv = NULL;
+    spectator_feed_destroy(server->spectatorFeed);
+    server->spectatorFeed = NULL;
+    tickloop_destroy(server->tickLoop);
+    server->tickLoop = NULL;
+    if (server->packet_in) SDLNet_FreePacket(server->packet_in);
+    if (server->transport) transport_close(server->transport);
+    server->packet_in = NULL;
+    server->transport = NULL;
+    replay_recorder_close(server->replay); // Match cut short, still a valid replay
+    server->replay = NULL;
+    savestate_writer_destroy(server->checkpointWriter); // Finishes a pending checkpoint
+    server->checkpointWriter = NULL;
+    arena_destroy(server->matchArena);
+    server->matchArena = NULL;
+    server->gameState = NULL;
+    server->snapshotScratch = NULL;
+    if (server->hosted) {
+        printf("Server shutdown complete.\n"); // The app shuts SDL down
+        return;
+    }
     if (server->debugRenderer) {
         cleanup_resources(&server->resources, &server->audio);
     }
@@ -458,11 +768,11 @@ static void shutdown_server(ServerInstance* server) {
 
 static void render_debug_view(ServerInstance* server) {
     if (!server->debugRenderer || !server->resources.font) return;
-    calculate_tower_rotations(&server->gameState, server->birdRotations);
+    calculate_tower_rotations(server->gameState, server->birdRotations);
     SDL_SetRenderDrawColor(server->debugRenderer, 0, 50, 0, 255);
     SDL_RenderClear(server->debugRenderer);
     render_game(server->debugRenderer,
-                &server->gameState,
+                server->gameState,
                 &server->resources,
                 server->birdRotations,
                 false,
@@ -470,17 +780,34 @@ static void render_debug_view(ServerInstance* server) {
                 -1);
     char st[128];
     snprintf(st, sizeof(st),
-             "Server - Clients: %d/%d Birds: %d",
+             "Server - Clients: %d/%d Spectators: %d Birds: %d",
              server->num_clients,
              MAX_PLAYERS,
-             server->gameState.numPlacedBirds
+             server->num_spectators,
+             server->gameState->numPlacedBirds
              );
-    render_text(server->debugRenderer,
-                server->resources.font,
+    render_text(server->resources.textCache,
                 st,
                 10,
                 10,
                 (SDL_Color){255,255,255,255},
                 false);
+    char tl[128];
+    snprintf(tl, sizeof(tl), "Tick late avg %.0f us max %.0f us  Tick %u hash %08x",
+             tickloop_lateness_avg_us(server->tickLoop), tickloop_lateness_max_us(server->tickLoop),
+             (unsigned)server->matchTick, (unsigned)server->stateHash);
+    render_text(server->resources.textCache, tl, 10, 40, (SDL_Color){255,255,255,255}, false);
+    // En rad nätverksstatistik per klient längst ner
+    for (int i = 0; i < server->num_clients; ++i) {
+        char line[256], stats[200];
+        netstats_format(&server->clients[i].stats, stats, sizeof stats);
+        snprintf(line, sizeof line, "P%d%s %s", i, server->clients[i].timedOut ? " (timeout)" : "", stats);
+        render_text(server->resources.textCache,
+                    line,
+                    10,
+                    WINDOW_HEIGHT - 30 * (server->num_clients - i),
+                    (SDL_Color){255,255,0,255},
+                    false);
+    }
     SDL_RenderPresent(server->debugRenderer);
 }
@@ -0,0 +1,128 @@
+// snapshot.c
+#include <string.h>
+#include "snapshot.h"
+
+static uint32_t hash_u32(uint32_t hash, uint32_t v) {
+    return hash_bytes(hash, &v, sizeof v);
+}
+
+// Floats by bit pattern, a checksum has to see every difference
+static uint32_t hash_f32(uint32_t hash, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof bits);
+    return hash_u32(hash, bits);
+}
+
+uint32_t snapshot_hash(const GameStateSnapshot *ss) {
+    if (!ss) return 0;
+    uint32_t h = STATE_HASH_SEED;
+    h = hash_u32(h, (uint32_t)ss->money);
+    h = hash_u32(h, (uint32_t)ss->leftPlayerHP);
+    h = hash_u32(h, (uint32_t)ss->rightPlayerHP);
+    h = hash_u32(h, (uint32_t)ss->currentWave);
+    h = hash_u32(h, (uint32_t)ss->winner);
+    h = hash_u32(h, ss->gameOver ? 1u : 0u);
+    // Same records and order as snapshot_encode, padding is never hashed
+    for (int i = 0; i < ss->numPlacedBirds; ++i) {
+        const BirdSnapshotData *b = &ss->placedBirds[i];
+        if (!b->active) continue;
+        h = hash_f32(h, b->x);
+        h = hash_f32(h, b->y);
+        h = hash_u32(h, (uint32_t)b->typeIndex);
+        h = hash_f32(h, b->attackAnimTimer);
+        h = hash_u32(h, (uint32_t)b->ownerPlayerIndex);
+    }
+    for (int i = 0; i < ss->numEnemiesActive; ++i) {
+        const EnemySnapshotData *e = &ss->enemies[i];
+        if (!e->active) continue;
+        h = hash_f32(h, e->x);
+        h = hash_f32(h, e->y);
+        h = hash_f32(h, e->angle);
+        h = hash_u32(h, (uint32_t)e->type);
+        h = hash_u32(h, (uint32_t)e->hp);
+        h = hash_u32(h, (uint32_t)e->side);
+    }
+    for (int i = 0; i < ss->numProjectiles; ++i) {
+        const ProjectileSnapshotData *p = &ss->projectiles[i];
+        if (!p->active) continue;
+        h = hash_f32(h, p->x);
+        h = hash_f32(h, p->y);
+        h = hash_f32(h, p->angle);
+        h = hash_u32(h, (uint32_t)p->projectileTextureIndex);
+    }
+    return h ? h : 1;
+}
+
+int snapshot_encode(const GameStateSnapshot *ss, uint8_t *buf, int cap) {
+    if (!ss || !buf || cap < SNAPSHOT_MAX_ENCODED_SIZE) return 0;
+
+    SnapshotWireHeader hdr = {
+        .money         = ss->money,
+        .leftPlayerHP  = ss->leftPlayerHP,
+        .rightPlayerHP = ss->rightPlayerHP,
+        .currentWave   = ss->currentWave,
+        .winner        = ss->winner,
+        .stateHash     = SNAPSHOT_STATE_HASH ? snapshot_hash(ss) : 0,
+        .gameOver      = ss->gameOver ? 1 : 0
+    };
+    uint8_t *p = buf + sizeof hdr;
+
+    // Inactive slots are skipped, the client only needs what it will draw
+    for (int i = 0; i < ss->numPlacedBirds; ++i) {
+        if (!ss->placedBirds[i].active) continue;
+        memcpy(p, &ss->placedBirds[i], sizeof(BirdSnapshotData));
+        p += sizeof(BirdSnapshotData);
+        hdr.numPlacedBirds++;
+    }
+    for (int i = 0; i < ss->numEnemiesActive; ++i) {
+        if (!ss->enemies[i].active) continue;
+        memcpy(p, &ss->enemies[i], sizeof(EnemySnapshotData));
+        p += sizeof(EnemySnapshotData);
+        hdr.numEnemiesActive++;
+    }
+    for (int i = 0; i < ss->numProjectiles; ++i) {
+        if (!ss->projectiles[i].active) continue;
+        memcpy(p, &ss->projectiles[i], sizeof(ProjectileSnapshotData));
+        p += sizeof(ProjectileSnapshotData);
+        hdr.numProjectiles++;
+    }
+
+    memcpy(buf, &hdr, sizeof hdr);
+    return (int)(p - buf);
+}
+
+// Copies up to count records of size recSize, stopping at the end of the buffer
+static int read_records(const uint8_t **p, const uint8_t *end, void *dst, int count, size_t recSize) {
+    int available = (int)((size_t)(end - *p) / recSize);
+    if (count > available) count = available;
+    memcpy(dst, *p, (size_t)count * recSize);
+    *p += (size_t)count * recSize;
+    return count;
+}
+
+bool snapshot_decode(const uint8_t *buf, int len, GameStateSnapshot *ss) {
+    if (!buf || !ss || len < (int)sizeof(SnapshotWireHeader)) return false;
+
+    SnapshotWireHeader hdr;
+    memcpy(&hdr, buf, sizeof hdr);
+    memset(ss, 0, sizeof *ss);
+    ss->money         = hdr.money;
+    ss->leftPlayerHP  = hdr.leftPlayerHP;
+    ss->rightPlayerHP = hdr.rightPlayerHP;
+    ss->currentWave   = hdr.currentWave;
+    ss->winner        = hdr.winner;
+    ss->gameOver      = hdr.gameOver != 0;
+
+    int birds       = hdr.numPlacedBirds   > MAX_PLACED_BIRDS ? MAX_PLACED_BIRDS : hdr.numPlacedBirds;
+    int enemies     = hdr.numEnemiesActive > MAX_ENEMIES      ? MAX_ENEMIES      : hdr.numEnemiesActive;
+    int projectiles = hdr.numProjectiles   > MAX_PROJECTILES  ? MAX_PROJECTILES  : hdr.numProjectiles;
+
+    const uint8_t *p   = buf + sizeof hdr;
+    const uint8_t *end = buf + len;
+    ss->numPlacedBirds   = read_records(&p, end, ss->placedBirds, birds, sizeof(BirdSnapshotData));
+    ss->numEnemiesActive = read_records(&p, end, ss->enemies, enemies, sizeof(EnemySnapshotData));
+    ss->numProjectiles   = read_records(&p, end, ss->projectiles, projectiles, sizeof(ProjectileSnapshotData));
+    bool complete = ss->numPlacedBirds == birds && ss->numEnemiesActive == enemies && ss->numProjectiles == projectiles;
+    ss->stateHash = complete ? hdr.stateHash : 0;
+    return true;
+}
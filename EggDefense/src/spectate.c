@@ -0,0 +1,206 @@
+// spectate.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spectate.h"
+
+// Equal bytes shorter than a run header are cheaper to resend than to skip
+#define DELTA_RUN_HEADER_SIZE 4
+#define DELTA_MAX_RUN 0xFFFF
+
+// Intern representation (sender)
+struct SpectatorFeed {
+    uint16_t nextFrameId;
+    uint16_t keyframeId;
+    bool hasKeyframe;
+    bool forceKeyframe;
+    int framesSinceKeyframe;
+    Uint8 keyframe[SNAPSHOT_MAX_ENCODED_SIZE];
+    int keyframeLen;
+    Uint8 current[SNAPSHOT_MAX_ENCODED_SIZE];
+    Uint8 frame[SPECTATOR_MAX_FRAME_SIZE];
+};
+
+// Intern representation (receiver)
+struct SpectatorView {
+    bool hasKeyframe;
+    uint16_t keyframeId;
+    Uint8 keyframe[SNAPSHOT_MAX_ENCODED_SIZE];
+    int keyframeLen;
+    Uint8 patched[SNAPSHOT_MAX_ENCODED_SIZE];
+};
+
+// --- Delta codec ---
+
+/**
+ * @brief Writes runs of bytes where cur differs from base (bytes past the end
+ * of base always differ).
+ * @return Bytes written, or 0 if the delta would need cap bytes or more.
+ */
+static int delta_encode(const Uint8 *base, int baseLen, const Uint8 *cur, int curLen, Uint8 *out, int cap) {
+    int written = 0;
+    int pos = 0;     // End of the previous run
+    int i = 0;
+    while (i < curLen) {
+        if (i < baseLen && cur[i] == base[i]) {
+            i++;
+            continue;
+        }
+        // Extend the run across short stretches of equal bytes
+        int start = i;
+        int end = i;
+        while (end < curLen && end - start < DELTA_MAX_RUN - DELTA_RUN_HEADER_SIZE) {
+            if (end >= baseLen || cur[end] != base[end]) {
+                end++;
+                continue;
+            }
+            int same = 0;
+            while (end + same < curLen && end + same < baseLen && cur[end + same] == base[end + same] &&
+                   same < DELTA_RUN_HEADER_SIZE) {
+                same++;
+            }
+            if (same >= DELTA_RUN_HEADER_SIZE || end + same >= curLen) break;
+            end += same;
+        }
+        int count = end - start;
+        int skip = start - pos;
+        while (skip > DELTA_MAX_RUN) {
+            // Empty run just to move forward
+            if (written + DELTA_RUN_HEADER_SIZE >= cap) return 0;
+            uint16_t hdr[2] = {DELTA_MAX_RUN, 0};
+            memcpy(out + written, hdr, sizeof hdr);
+            written += DELTA_RUN_HEADER_SIZE;
+            skip -= DELTA_MAX_RUN;
+        }
+        if (written + DELTA_RUN_HEADER_SIZE + count >= cap) return 0;
+        uint16_t hdr[2] = {(uint16_t)skip, (uint16_t)count};
+        memcpy(out + written, hdr, sizeof hdr);
+        memcpy(out + written + DELTA_RUN_HEADER_SIZE, cur + start, (size_t)count);
+        written += DELTA_RUN_HEADER_SIZE + count;
+        pos = end;
+        i = end;
+    }
+    if (written == 0) {
+        // Unchanged frame still needs a body to tell it apart from an empty keyframe
+        if (cap <= DELTA_RUN_HEADER_SIZE) return 0;
+        uint16_t hdr[2] = {0, 0};
+        memcpy(out, hdr, sizeof hdr);
+        written = DELTA_RUN_HEADER_SIZE;
+    }
+    return written;
+}
+
+static bool delta_apply(Uint8 *target, int targetLen, const Uint8 *delta, int deltaLen) {
+    int pos = 0;
+    int i = 0;
+    while (i + DELTA_RUN_HEADER_SIZE <= deltaLen) {
+        uint16_t hdr[2];
+        memcpy(hdr, delta + i, sizeof hdr);
+        i += DELTA_RUN_HEADER_SIZE;
+        pos += hdr[0];
+        if (hdr[1] > deltaLen - i || pos + hdr[1] > targetLen) return false;
+        memcpy(target + pos, delta + i, hdr[1]);
+        pos += hdr[1];
+        i += hdr[1];
+    }
+    return i == deltaLen;
+}
+
+// --- Feed ---
+
+SpectatorFeed *spectator_feed_create(void) {
+    SpectatorFeed *feed = calloc(1, sizeof *feed);
+    if (!feed) perror("Failed to allocate spectator feed");
+    return feed;
+}
+
+void spectator_feed_destroy(SpectatorFeed *feed) {
+    free(feed);
+}
+
+void spectator_feed_force_keyframe(SpectatorFeed *feed) {
+    if (feed) feed->forceKeyframe = true;
+}
+
+const Uint8 *spectator_feed_encode(SpectatorFeed *feed, const GameStateSnapshot *snapshot, int *outLen) {
+    if (!feed || !snapshot || !outLen) return NULL;
+    int len = snapshot_encode(snapshot, feed->current, SNAPSHOT_MAX_ENCODED_SIZE);
+    if (len <= 0) return NULL;
+
+    SpectatorFrameHeader hdr = {
+        .frameId      = feed->nextFrameId++,
+        .snapshotSize = (uint32_t)len
+    };
+    Uint8 *payload = feed->frame + sizeof hdr;
+    int payloadLen = 0;
+    bool keyframe = !feed->hasKeyframe || feed->forceKeyframe ||
+                    feed->framesSinceKeyframe + 1 >= SPECTATOR_KEYFRAME_INTERVAL;
+    if (!keyframe) {
+        payloadLen = delta_encode(feed->keyframe, feed->keyframeLen, feed->current, len, payload, len);
+        keyframe = (payloadLen == 0);
+    }
+    if (keyframe) {
+        memcpy(payload, feed->current, (size_t)len);
+        memcpy(feed->keyframe, feed->current, (size_t)len);
+        feed->keyframeLen         = len;
+        feed->keyframeId          = hdr.frameId;
+        feed->hasKeyframe         = true;
+        feed->forceKeyframe       = false;
+        feed->framesSinceKeyframe = 0;
+        payloadLen = len;
+    } else {
+        feed->framesSinceKeyframe++;
+    }
+    hdr.keyframeId  = feed->keyframeId;
+    hdr.payloadSize = (uint32_t)payloadLen;
+    memcpy(feed->frame, &hdr, sizeof hdr);
+    *outLen = (int)sizeof hdr + payloadLen;
+    return feed->frame;
+}
+
+bool spectator_frame_is_keyframe(const Uint8 *frame, int len) {
+    if (!frame || len < (int)sizeof(SpectatorFrameHeader)) return false;
+    SpectatorFrameHeader hdr;
+    memcpy(&hdr, frame, sizeof hdr);
+    return hdr.keyframeId == hdr.frameId;
+}
+
+// --- View ---
+
+SpectatorView *spectator_view_create(void) {
+    SpectatorView *view = calloc(1, sizeof *view);
+    if (!view) perror("Failed to allocate spectator view");
+    return view;
+}
+
+void spectator_view_destroy(SpectatorView *view) {
+    free(view);
+}
+
+bool spectator_view_apply(SpectatorView *view, const Uint8 *frame, int len, GameStateSnapshot *out) {
+    if (!view || !frame || !out || len < (int)sizeof(SpectatorFrameHeader)) return false;
+    SpectatorFrameHeader hdr;
+    memcpy(&hdr, frame, sizeof hdr);
+    const Uint8 *payload = frame + sizeof hdr;
+    if (hdr.payloadSize > (uint32_t)(len - (int)sizeof hdr) ||
+        hdr.snapshotSize > (uint32_t)SNAPSHOT_MAX_ENCODED_SIZE) {
+        return false; // Truncated (lost fragments) or corrupt
+    }
+
+    if (hdr.keyframeId == hdr.frameId) {
+        if (hdr.payloadSize != hdr.snapshotSize) return false;
+        memcpy(view->keyframe, payload, hdr.payloadSize);
+        view->keyframeLen = (int)hdr.payloadSize;
+        view->keyframeId  = hdr.keyframeId;
+        view->hasKeyframe = true;
+        return snapshot_decode(view->keyframe, view->keyframeLen, out);
+    }
+
+    if (!view->hasKeyframe || view->keyframeId != hdr.keyframeId) return false;
+    int size = (int)hdr.snapshotSize;
+    int common = (size < view->keyframeLen) ? size : view->keyframeLen;
+    memcpy(view->patched, view->keyframe, (size_t)common);
+    if (size > common) memset(view->patched + common, 0, (size_t)(size - common));
+    if (!delta_apply(view->patched, size, payload, (int)hdr.payloadSize)) return false;
+    return snapshot_decode(view->patched, size, out);
+}
@@ -0,0 +1,139 @@
+// spritebatch.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "spritebatch.h"
+
+#define SPRITEBATCH_INITIAL_QUADS 256
+
+// All quads of one texture
+typedef struct {
+    SDL_Texture *texture;
+    float invW, invH;       // 1 / texture size, for UV coordinates
+    SDL_Vertex *vertices;   // 4 per quad
+    int numQuads;
+    int capacity;           // In quads
+} SpriteGroup;
+
+// Intern representation
+struct SpriteBatch {
+    SDL_Renderer *renderer;
+    SpriteGroup groups[SPRITEBATCH_MAX_TEXTURES];
+    int numGroups;
+    int *indices;           // 0,1,2, 2,3,0 per quad; identical for every group
+    int indexCapacity;      // In quads
+};
+
+static bool ensure_indices(SpriteBatch *batch, int quads) {
+    if (quads <= batch->indexCapacity) return true;
+    int capacity = batch->indexCapacity ? batch->indexCapacity : SPRITEBATCH_INITIAL_QUADS;
+    while (capacity < quads) capacity *= 2;
+    int *indices = realloc(batch->indices, (size_t)capacity * 6 * sizeof(int));
+    if (!indices) {
+        printf("SpriteBatch: out of memory for %d quads\n", capacity);
+        return false;
+    }
+    for (int q = batch->indexCapacity; q < capacity; ++q) {
+        int v = q * 4;
+        int *i = &indices[q * 6];
+        i[0] = v; i[1] = v + 1; i[2] = v + 2;
+        i[3] = v + 2; i[4] = v + 3; i[5] = v;
+    }
+    batch->indices = indices;
+    batch->indexCapacity = capacity;
+    return true;
+}
+
+SpriteBatch *spritebatch_create(SDL_Renderer *renderer) {
+    if (!renderer) return NULL;
+    SpriteBatch *batch = calloc(1, sizeof *batch);
+    if (!batch) return NULL;
+    batch->renderer = renderer;
+    if (!ensure_indices(batch, SPRITEBATCH_INITIAL_QUADS)) {
+        free(batch);
+        return NULL;
+    }
+    return batch;
+}
+
+void spritebatch_destroy(SpriteBatch *batch) {
+    if (!batch) return;
+    for (int g = 0; g < SPRITEBATCH_MAX_TEXTURES; ++g) free(batch->groups[g].vertices);
+    free(batch->indices);
+    free(batch);
+}
+
+static SpriteGroup *group_for(SpriteBatch *batch, SDL_Texture *texture) {
+    for (int g = 0; g < batch->numGroups; ++g) {
+        if (batch->groups[g].texture == texture) return &batch->groups[g];
+    }
+    if (batch->numGroups == SPRITEBATCH_MAX_TEXTURES) spritebatch_flush(batch);
+
+    SpriteGroup *group = &batch->groups[batch->numGroups++];
+    int w = 1, h = 1;
+    SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+    group->texture = texture;
+    group->invW = 1.0f / (float)(w > 0 ? w : 1);
+    group->invH = 1.0f / (float)(h > 0 ? h : 1);
+    group->numQuads = 0;
+    return group;
+}
+
+void spritebatch_add(SpriteBatch *batch, SDL_Texture *texture, const SDL_Rect *src,
+                     float cx, float cy, float w, float h, float angleDeg, Uint8 alpha) {
+    if (!batch || !texture) return;
+    SpriteGroup *group = group_for(batch, texture);
+    if (group->numQuads == group->capacity) {
+        int capacity = group->capacity ? group->capacity * 2 : SPRITEBATCH_INITIAL_QUADS;
+        SDL_Vertex *vertices = realloc(group->vertices, (size_t)capacity * 4 * sizeof(SDL_Vertex));
+        if (!vertices || !ensure_indices(batch, capacity)) {
+            if (vertices) group->vertices = vertices;
+            return; // Sprite dropped this frame
+        }
+        group->vertices = vertices;
+        group->capacity = capacity;
+    }
+
+    // UV rect
+    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+    if (src) {
+        u0 = (float)src->x * group->invW;
+        v0 = (float)src->y * group->invH;
+        u1 = (float)(src->x + src->w) * group->invW;
+        v1 = (float)(src->y + src->h) * group->invH;
+    }
+
+    // Rotate the half extents once; the four corners are sign flips of these
+    float rad = angleDeg * (float)M_PI / 180.0f;
+    float c = cosf(rad), s = sinf(rad);
+    float hw = w * 0.5f, hh = h * 0.5f;
+    float ax = hw * c, ay = hw * s;   // Rotated (+hw, 0)
+    float bx = -hh * s, by = hh * c;  // Rotated (0, +hh)
+
+    SDL_Color color = {255, 255, 255, alpha};
+    SDL_Vertex *v = &group->vertices[group->numQuads * 4];
+    v[0] = (SDL_Vertex){ {cx - ax - bx, cy - ay - by}, color, {u0, v0} }; // Top left
+    v[1] = (SDL_Vertex){ {cx + ax - bx, cy + ay - by}, color, {u1, v0} }; // Top right
+    v[2] = (SDL_Vertex){ {cx + ax + bx, cy + ay + by}, color, {u1, v1} }; // Bottom right
+    v[3] = (SDL_Vertex){ {cx - ax + bx, cy - ay + by}, color, {u0, v1} }; // Bottom left
+    group->numQuads++;
+}
+
+int spritebatch_flush(SpriteBatch *batch) {
+    if (!batch) return 0;
+    int drawCalls = 0;
+    for (int g = 0; g < batch->numGroups; ++g) {
+        SpriteGroup *group = &batch->groups[g];
+        if (group->numQuads == 0) continue;
+        if (SDL_RenderGeometry(batch->renderer, group->texture,
+                               group->vertices, group->numQuads * 4,
+                               batch->indices, group->numQuads * 6) != 0) {
+            printf("SDL_RenderGeometry Error: %s\n", SDL_GetError());
+        }
+        group->numQuads = 0;
+        drawCalls++;
+    }
+    batch->numGroups = 0;
+    return drawCalls;
+}
@@ -0,0 +1,130 @@
+// statehash.c
+#include <stdio.h>
+#include <string.h>
+#include "engine.h"
+
+// One pass over the simulation fields of a, in a fixed order. Hashing folds
+// every field in; diffing (b != NULL) stops at the first field that differs
+// and names it. UI state and render caches (placingBird, selectedOption,
+// towerVersion) are left out, they do not affect the simulation. Bird.cover
+// is left out too, it follows from x, y and range.
+typedef struct {
+    const GameState *a;
+    const GameState *b;     // NULL when only hashing
+    Uint32 hash;
+    bool differs;
+    char *out;              // Name and values of the first difference
+    size_t cap;
+} StateWalk;
+
+static void field_name(char *buf, size_t cap, const char *group, int index, const char *name) {
+    if (index < 0) snprintf(buf, cap, "%s", name);
+    else snprintf(buf, cap, "%s[%d].%s", group, index, name);
+}
+
+static void walk_int(StateWalk *w, const char *group, int index, const char *name, int va, int vb) {
+    if (w->differs) return;
+    w->hash = hash_bytes(w->hash, &va, sizeof va);
+    if (!w->b || va == vb) return;
+    char field[64];
+    field_name(field, sizeof field, group, index, name);
+    snprintf(w->out, w->cap, "%s: %d vs %d", field, va, vb);
+    w->differs = true;
+}
+
+// Compared by bit pattern: -0.0 vs 0.0 or two NaNs count as different
+static void walk_float(StateWalk *w, const char *group, int index, const char *name, float va, float vb) {
+    if (w->differs) return;
+    Uint32 ba, bb;
+    memcpy(&ba, &va, sizeof ba);
+    memcpy(&bb, &vb, sizeof bb);
+    w->hash = hash_bytes(w->hash, &ba, sizeof ba);
+    if (!w->b || ba == bb) return;
+    char field[64];
+    field_name(field, sizeof field, group, index, name);
+    snprintf(w->out, w->cap, "%s: %.9g vs %.9g (%08x vs %08x)", field, va, vb, (unsigned)ba, (unsigned)bb);
+    w->differs = true;
+}
+
+// Reads the same field of both states, b's only when diffing
+#define WALK_INT(w, group, index, name, field) \
+    walk_int(w, group, index, name, (int)(w)->a->field, (w)->b ? (int)(w)->b->field : 0)
+#define WALK_FLOAT(w, group, index, name, field) \
+    walk_float(w, group, index, name, (w)->a->field, (w)->b ? (w)->b->field : 0.0f)
+
+static void walk_state(StateWalk *w) {
+    WALK_INT(w, NULL, -1, "nextEntityId", nextEntityId);
+    WALK_INT(w, NULL, -1, "leftPlayerHP", leftPlayerHP);
+    WALK_INT(w, NULL, -1, "rightPlayerHP", rightPlayerHP);
+    WALK_INT(w, NULL, -1, "gameOver", gameOver);
+    WALK_INT(w, NULL, -1, "winner", winner);
+    WALK_INT(w, NULL, -1, "currentWave", currentWave);
+    WALK_FLOAT(w, NULL, -1, "spawnCooldown", spawnCooldown);
+    WALK_INT(w, NULL, -1, "inWaveDelay", inWaveDelay);
+    WALK_FLOAT(w, NULL, -1, "spawnTimer", spawnTimer);
+    WALK_INT(w, NULL, -1, "enemySpawnCounter", enemySpawnCounter);
+    for (int t = 0; t < NUM_TEAMS; ++t) {
+        WALK_INT(w, "team_money", t, "current_money", team_money[t].current_money);
+        WALK_FLOAT(w, "team_money", t, "money_timer", team_money[t].money_timer);
+    }
+
+    // Counts first: while diffing, the loops below only run when they match
+    WALK_INT(w, NULL, -1, "numEnemiesActive", numEnemiesActive);
+    for (int i = 0; i < w->a->numEnemiesActive && !w->differs; ++i) {
+        WALK_INT(w, "enemies", i, "id", enemies[i].id);
+        WALK_INT(w, "enemies", i, "active", enemies[i].active);
+        WALK_INT(w, "enemies", i, "type", enemies[i].type);
+        WALK_INT(w, "enemies", i, "side", enemies[i].side);
+        WALK_INT(w, "enemies", i, "hp", enemies[i].hp);
+        WALK_INT(w, "enemies", i, "spriteIndex", enemies[i].spriteIndex);
+        WALK_FLOAT(w, "enemies", i, "speed", enemies[i].speed);
+        WALK_INT(w, "enemies", i, "currentSegment", enemies[i].currentSegment);
+        WALK_FLOAT(w, "enemies", i, "segmentProgress", enemies[i].segmentProgress);
+        WALK_FLOAT(w, "enemies", i, "x", enemies[i].x);
+        WALK_FLOAT(w, "enemies", i, "y", enemies[i].y);
+        WALK_FLOAT(w, "enemies", i, "angle", enemies[i].angle);
+    }
+    WALK_INT(w, NULL, -1, "numPlacedBirds", numPlacedBirds);
+    for (int i = 0; i < w->a->numPlacedBirds && !w->differs; ++i) {
+        WALK_INT(w, "placedBirds", i, "active", placedBirds[i].active);
+        WALK_INT(w, "placedBirds", i, "towerTypeIndex", placedBirds[i].towerTypeIndex);
+        WALK_INT(w, "placedBirds", i, "ownerPlayerIndex", placedBirds[i].ownerPlayerIndex);
+        WALK_INT(w, "placedBirds", i, "damage", placedBirds[i].damage);
+        WALK_FLOAT(w, "placedBirds", i, "range", placedBirds[i].range);
+        WALK_FLOAT(w, "placedBirds", i, "attackSpeed", placedBirds[i].attackSpeed);
+        WALK_INT(w, "placedBirds", i, "cost", placedBirds[i].cost);
+        WALK_INT(w, "placedBirds", i, "projectileTextureIndex", placedBirds[i].projectileTextureIndex);
+        WALK_FLOAT(w, "placedBirds", i, "x", placedBirds[i].x);
+        WALK_FLOAT(w, "placedBirds", i, "y", placedBirds[i].y);
+        WALK_FLOAT(w, "placedBirds", i, "attackTimer", placedBirds[i].attackTimer);
+        WALK_FLOAT(w, "placedBirds", i, "attackAnimTimer", placedBirds[i].attackAnimTimer);
+        WALK_FLOAT(w, "placedBirds", i, "rotation", placedBirds[i].rotation);
+        WALK_INT(w, "placedBirds", i, "damageDealt", placedBirds[i].damageDealt);
+    }
+    WALK_INT(w, NULL, -1, "numProjectiles", numProjectiles);
+    for (int i = 0; i < w->a->numProjectiles && !w->differs; ++i) {
+        WALK_INT(w, "projectiles", i, "id", projectiles[i].id);
+        WALK_INT(w, "projectiles", i, "active", projectiles[i].active);
+        WALK_INT(w, "projectiles", i, "textureIndex", projectiles[i].textureIndex);
+        WALK_FLOAT(w, "projectiles", i, "x", projectiles[i].x);
+        WALK_FLOAT(w, "projectiles", i, "y", projectiles[i].y);
+        WALK_FLOAT(w, "projectiles", i, "vx", projectiles[i].vx);
+        WALK_FLOAT(w, "projectiles", i, "vy", projectiles[i].vy);
+        WALK_FLOAT(w, "projectiles", i, "angle", projectiles[i].angle);
+    }
+}
+
+Uint32 state_hash(const GameState *gameState) {
+    if (!gameState) return 0;
+    StateWalk w = { .a = gameState, .hash = STATE_HASH_SEED };
+    walk_state(&w);
+    return w.hash ? w.hash : 1;
+}
+
+bool state_hash_diff(const GameState *a, const GameState *b, char *out, size_t cap) {
+    if (!a || !b || !out || cap == 0) return false;
+    out[0] = '\0';
+    StateWalk w = { .a = a, .b = b, .hash = STATE_HASH_SEED, .out = out, .cap = cap };
+    walk_state(&w);
+    return w.differs;
+}
@@ -0,0 +1,120 @@
+// textcache.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "textcache.h"
+
+typedef struct {
+    SDL_Texture *texture;   // NULL = free slot
+    Uint32 hash;
+    SDL_Color color;
+    int w, h;
+    Uint32 lastUsed;
+    char text[TEXT_CACHE_MAX_TEXT];
+} TextCacheEntry;
+
+// Intern representation
+struct TextCache {
+    SDL_Renderer *renderer;
+    TTF_Font *font;
+    Uint32 useCounter;
+    TextCacheEntry entries[TEXT_CACHE_SIZE];
+};
+
+TextCache *text_cache_create(SDL_Renderer *renderer, TTF_Font *font) {
+    if (!renderer || !font) return NULL;
+    TextCache *cache = calloc(1, sizeof *cache);
+    if (!cache) return NULL;
+    cache->renderer = renderer;
+    cache->font = font;
+    return cache;
+}
+
+void text_cache_destroy(TextCache *cache) {
+    if (!cache) return;
+    for (int i = 0; i < TEXT_CACHE_SIZE; ++i) {
+        if (cache->entries[i].texture) SDL_DestroyTexture(cache->entries[i].texture);
+    }
+    free(cache);
+}
+
+// FNV-1a over the text, then the colour
+static Uint32 hash_text(const char *text, SDL_Color color, size_t *len) {
+    Uint32 h = 2166136261u;
+    const char *c = text;
+    for (; *c; ++c) h = (h ^ (Uint8)*c) * 16777619u;
+    *len = (size_t)(c - text);
+    h = (h ^ color.r) * 16777619u;
+    h = (h ^ color.g) * 16777619u;
+    h = (h ^ color.b) * 16777619u;
+    h = (h ^ color.a) * 16777619u;
+    return h;
+}
+
+static SDL_Texture *render_string(TextCache *cache, const char *text, SDL_Color color, int *w, int *h) {
+    SDL_Surface *surface = TTF_RenderText_Solid(cache->font, text, color);
+    if (!surface) return NULL;
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(cache->renderer, surface);
+    SDL_FreeSurface(surface);
+    if (texture) SDL_QueryTexture(texture, NULL, NULL, w, h);
+    return texture;
+}
+
+// Finds or renders the entry; NULL if the text is too long to cache or failed
+static TextCacheEntry *lookup(TextCache *cache, const char *text, SDL_Color color) {
+    size_t len;
+    Uint32 hash = hash_text(text, color, &len);
+    if (len >= TEXT_CACHE_MAX_TEXT) return NULL;
+
+    TextCacheEntry *victim = &cache->entries[0];
+    for (int i = 0; i < TEXT_CACHE_SIZE; ++i) {
+        TextCacheEntry *e = &cache->entries[i];
+        if (e->texture && e->hash == hash && strcmp(e->text, text) == 0 &&
+            e->color.r == color.r && e->color.g == color.g && e->color.b == color.b && e->color.a == color.a) {
+            e->lastUsed = ++cache->useCounter;
+            return e;
+        }
+        // Free slot first, otherwise the least recently used one
+        if (victim->texture && (!e->texture || e->lastUsed < victim->lastUsed)) victim = e;
+    }
+
+    SDL_Texture *texture = render_string(cache, text, color, &victim->w, &victim->h);
+    if (!texture) return NULL;
+    if (victim->texture) SDL_DestroyTexture(victim->texture);
+    victim->texture = texture;
+    victim->hash = hash;
+    victim->color = color;
+    memcpy(victim->text, text, len + 1);
+    victim->lastUsed = ++cache->useCounter;
+    return victim;
+}
+
+bool text_cache_measure(TextCache *cache, const char *text, SDL_Color color, int *w, int *h) {
+    if (!cache || !text) return false;
+    TextCacheEntry *e = lookup(cache, text, color);
+    if (e) {
+        if (w) *w = e->w;
+        if (h) *h = e->h;
+        return true;
+    }
+    return TTF_SizeText(cache->font, text, w, h) == 0;
+}
+
+void render_text(TextCache *cache, const char *text, int x, int y, SDL_Color color, bool center) {
+    if (!cache || !text || text[0] == '\0') return;
+    SDL_Rect dstRect = {x, y, 0, 0};
+    TextCacheEntry *e = lookup(cache, text, color);
+    if (e) {
+        dstRect.w = e->w;
+        dstRect.h = e->h;
+        if (center) dstRect.x = x - dstRect.w / 2;
+        SDL_RenderCopy(cache->renderer, e->texture, NULL, &dstRect);
+        return;
+    }
+    // Too long to cache: render once and throw away
+    SDL_Texture *texture = render_string(cache, text, color, &dstRect.w, &dstRect.h);
+    if (!texture) return;
+    if (center) dstRect.x = x - dstRect.w / 2;
+    SDL_RenderCopy(cache->renderer, texture, NULL, &dstRect);
+    SDL_DestroyTexture(texture);
+}
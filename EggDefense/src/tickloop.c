@@ -0,0 +1,224 @@
+// tickloop.c
+#if defined(__linux__) && !defined(TICKLOOP_NO_EPOLL)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#define TICKLOOP_USE_EPOLL 1
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tickloop.h"
+
+#ifdef TICKLOOP_USE_EPOLL
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/prctl.h>
+#endif
+
+#define NS_PER_SEC 1000000000ULL
+
+// Intern representation
+struct TickLoop {
+    int tickRate;
+    bool idle;
+    Uint64 periodNs;
+    Uint64 startNs;         // Deadline of tick 0 in the current schedule
+    Uint64 ticksScheduled;  // Ticks handed out since startNs
+    float latenessAvgUs;
+    float latenessMaxUs;
+#ifdef TICKLOOP_USE_EPOLL
+    int epollFd;
+    int timerFd;
+    int socketFd;           // -1 if the transport has no pollable socket
+#else
+    Transport *transport;
+#endif
+};
+
+#ifdef TICKLOOP_USE_EPOLL
+static Uint64 now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (Uint64)ts.tv_sec * NS_PER_SEC + (Uint64)ts.tv_nsec;
+}
+#else
+static Uint64 now_ns(void) {
+    static Uint64 freq = 0;
+    if (freq == 0) freq = SDL_GetPerformanceFrequency();
+    Uint64 c = SDL_GetPerformanceCounter();
+    return (c / freq) * NS_PER_SEC + (c % freq) * NS_PER_SEC / freq;
+}
+#endif
+
+// Deadline of tick n, computed from the start so rounding never accumulates
+static Uint64 deadline_of(const TickLoop *loop, Uint64 n) {
+    if (loop->idle) return loop->startNs + n * loop->periodNs;
+    return loop->startNs + n * NS_PER_SEC / (Uint64)loop->tickRate;
+}
+
+static void restart_schedule(TickLoop *loop) {
+    loop->periodNs = loop->idle ? (Uint64)SERVER_IDLE_TICK_MS * 1000000ULL
+                                : NS_PER_SEC / (Uint64)loop->tickRate;
+    loop->startNs = now_ns() + loop->periodNs;
+    loop->ticksScheduled = 0;
+}
+
+// Counts the ticks whose deadline has passed and records the wakeup lateness
+static int collect_due_ticks(TickLoop *loop, Uint64 now) {
+    int due = 0;
+    Uint64 firstDeadline = deadline_of(loop, loop->ticksScheduled);
+    while (deadline_of(loop, loop->ticksScheduled) <= now) {
+        loop->ticksScheduled++;
+        due++;
+        if (due > GAME_TICK_RATE) {
+            // Hopelessly behind (debugger, suspend): start over instead of catching up
+            restart_schedule(loop);
+            return 1;
+        }
+    }
+    if (due > 0) {
+        float lateUs = (float)(now - firstDeadline) / 1000.0f;
+        loop->latenessAvgUs += (lateUs - loop->latenessAvgUs) * 0.05f;
+        if (lateUs > loop->latenessMaxUs) loop->latenessMaxUs = lateUs;
+    }
+    return due;
+}
+
+#ifdef TICKLOOP_USE_EPOLL
+
+TickLoop *tickloop_create(Transport *transport, int tickRate) {
+    TickLoop *loop = calloc(1, sizeof *loop);
+    if (!loop) {
+        perror("Failed to allocate tick loop");
+        return NULL;
+    }
+    loop->tickRate = (tickRate > 0) ? tickRate : GAME_TICK_RATE;
+    loop->socketFd = transport_fd(transport);
+    // Default 50 us timer slack would be most of the wakeup error
+    prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+    loop->epollFd  = epoll_create1(EPOLL_CLOEXEC);
+    loop->timerFd  = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (loop->epollFd < 0 || loop->timerFd < 0) {
+        perror("tick loop epoll/timerfd");
+        tickloop_destroy(loop);
+        return NULL;
+    }
+
+    struct epoll_event ev = {0};
+    ev.events  = EPOLLIN;
+    ev.data.fd = loop->timerFd;
+    epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->timerFd, &ev);
+    if (loop->socketFd >= 0) {
+        ev.data.fd = loop->socketFd;
+        epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->socketFd, &ev);
+    } else {
+        printf("Warn: transport has no pollable socket, waking on ticks only\n");
+    }
+    restart_schedule(loop);
+    return loop;
+}
+
+void tickloop_destroy(TickLoop *loop) {
+    if (!loop) return;
+    if (loop->timerFd >= 0) close(loop->timerFd);
+    if (loop->epollFd >= 0) close(loop->epollFd);
+    free(loop);
+}
+
+int tickloop_wait(TickLoop *loop) {
+    if (!loop) return 0;
+    // One-shot absolute timer at the exact next deadline (a periodic timer
+    // with a whole-ns interval would slowly drift from deadline_of)
+    Uint64 deadline = deadline_of(loop, loop->ticksScheduled);
+    struct itimerspec its = {0};
+    its.it_value.tv_sec  = (time_t)(deadline / NS_PER_SEC);
+    its.it_value.tv_nsec = (long)(deadline % NS_PER_SEC);
+    if (timerfd_settime(loop->timerFd, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+        perror("timerfd_settime");
+    }
+
+    struct epoll_event events[2];
+    int n = epoll_wait(loop->epollFd, events, 2, -1);
+    if (n < 0 && errno != EINTR) perror("epoll_wait");
+
+    for (int i = 0; i < n; ++i) {
+        if (events[i].data.fd == loop->timerFd) {
+            Uint64 expirations;
+            // Only clears readiness; tick counting uses the deadlines themselves
+            if (read(loop->timerFd, &expirations, sizeof expirations) < 0 && errno != EAGAIN) {
+                perror("timerfd read");
+            }
+        }
+    }
+    return collect_due_ticks(loop, now_ns());
+}
+
+const char *tickloop_backend_name(const TickLoop *loop) {
+    return "epoll+timerfd";
+}
+
+#else // Portable absolute-deadline scheduler
+
+TickLoop *tickloop_create(Transport *transport, int tickRate) {
+    TickLoop *loop = calloc(1, sizeof *loop);
+    if (!loop) {
+        perror("Failed to allocate tick loop");
+        return NULL;
+    }
+    loop->tickRate  = (tickRate > 0) ? tickRate : GAME_TICK_RATE;
+    loop->transport = transport;
+    restart_schedule(loop);
+    return loop;
+}
+
+void tickloop_destroy(TickLoop *loop) {
+    free(loop);
+}
+
+// Without socket readiness packets are picked up once per tick. SDL_Delay
+// oversleeps, so it stops about 1 ms short and the rest is yielded away;
+// idle loops just sleep out the whole (long) period.
+int tickloop_wait(TickLoop *loop) {
+    if (!loop) return 0;
+    Uint64 deadline = deadline_of(loop, loop->ticksScheduled);
+    Uint64 now = now_ns();
+    if (now < deadline) {
+        Uint64 remaining = deadline - now;
+        if (loop->idle) {
+            SDL_Delay((Uint32)((remaining + 999999ULL) / 1000000ULL));
+        } else {
+            if (remaining > 1000000ULL) {
+                SDL_Delay((Uint32)((remaining - 1000000ULL) / 1000000ULL));
+            }
+            while (now_ns() < deadline) {
+                SDL_Delay(0); // Ge bort tidsluckan i stället för att spinna
+            }
+        }
+    }
+    return collect_due_ticks(loop, now_ns());
+}
+
+const char *tickloop_backend_name(const TickLoop *loop) {
+    return "deadline";
+}
+
+#endif
+
+void tickloop_set_idle(TickLoop *loop, bool idle) {
+    if (!loop || loop->idle == idle) return;
+    loop->idle = idle;
+    restart_schedule(loop);
+}
+
+float tickloop_lateness_avg_us(const TickLoop *loop) {
+    return loop ? loop->latenessAvgUs : 0.0f;
+}
+
+float tickloop_lateness_max_us(const TickLoop *loop) {
+    return loop ? loop->latenessMaxUs : 0.0f;
+}
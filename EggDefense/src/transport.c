@@ -0,0 +1,293 @@
+// transport.c
+#if defined(__linux__) && !defined(TRANSPORT_NO_MMSG)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // recvmmsg/sendmmsg
+#endif
+#define TRANSPORT_USE_MMSG 1
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "transport.h"
+#include "netcond.h"
+
+#ifdef TRANSPORT_USE_MMSG
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+// Intern representation (Linux, batched syscalls)
+struct Transport {
+    int fd;
+    NetConditioner *condIn, *condOut; // NULL unless impairment is enabled
+
+    // Inbound batch filled by one recvmmsg, handed out one datagram at a time
+    struct mmsghdr inMsgs[TRANSPORT_BATCH_SIZE];
+    struct iovec inIov[TRANSPORT_BATCH_SIZE];
+    struct sockaddr_in inAddr[TRANSPORT_BATCH_SIZE];
+    Uint8 inBuf[TRANSPORT_BATCH_SIZE][PACKET_BUFFER_SIZE];
+    int inCount;
+    int inNext;
+
+    // Outbound queue flushed by one sendmmsg
+    struct mmsghdr outMsgs[TRANSPORT_BATCH_SIZE];
+    struct iovec outIov[TRANSPORT_BATCH_SIZE];
+    struct sockaddr_in outAddr[TRANSPORT_BATCH_SIZE];
+    Uint8 outBuf[TRANSPORT_BATCH_SIZE][PACKET_BUFFER_SIZE];
+    int outCount;
+};
+
+Transport *transport_open(Uint16 port) {
+    Transport *t = calloc(1, sizeof *t);
+    if (!t) {
+        perror("Failed to allocate transport");
+        return NULL;
+    }
+
+    t->fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (t->fd < 0) {
+        perror("transport socket");
+        free(t);
+        return NULL;
+    }
+
+    struct sockaddr_in bindAddr = {0};
+    bindAddr.sin_family      = AF_INET;
+    bindAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    bindAddr.sin_port        = htons(port);
+    if (bind(t->fd, (struct sockaddr *)&bindAddr, sizeof bindAddr) < 0) {
+        perror("transport bind");
+        close(t->fd);
+        free(t);
+        return NULL;
+    }
+
+    // Message headers point at fixed buffers, so they are wired up once
+    for (int i = 0; i < TRANSPORT_BATCH_SIZE; ++i) {
+        t->inIov[i].iov_base = t->inBuf[i];
+        t->inIov[i].iov_len  = PACKET_BUFFER_SIZE;
+        t->inMsgs[i].msg_hdr.msg_iov    = &t->inIov[i];
+        t->inMsgs[i].msg_hdr.msg_iovlen = 1;
+        t->inMsgs[i].msg_hdr.msg_name   = &t->inAddr[i];
+
+        t->outIov[i].iov_base = t->outBuf[i];
+        t->outMsgs[i].msg_hdr.msg_iov     = &t->outIov[i];
+        t->outMsgs[i].msg_hdr.msg_iovlen  = 1;
+        t->outMsgs[i].msg_hdr.msg_name    = &t->outAddr[i];
+        t->outMsgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+    return t;
+}
+
+static int backend_flush(Transport *t);
+
+static void backend_close(Transport *t) {
+    backend_flush(t);
+    close(t->fd);
+}
+
+// Refills the inbound batch with a single syscall
+static int refill_inbound(Transport *t) {
+    for (int i = 0; i < TRANSPORT_BATCH_SIZE; ++i) {
+        t->inMsgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+    int n = recvmmsg(t->fd, t->inMsgs, TRANSPORT_BATCH_SIZE, MSG_DONTWAIT, NULL);
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+        perror("recvmmsg");
+        return -1;
+    }
+    t->inCount = n;
+    t->inNext  = 0;
+    return n;
+}
+
+static int backend_recv(Transport *t, UDPpacket *packet) {
+    if (t->inNext >= t->inCount) {
+        int n = refill_inbound(t);
+        if (n <= 0) return n;
+    }
+
+    int i = t->inNext++;
+    int len = (int)t->inMsgs[i].msg_len;
+    if (len > packet->maxlen) len = packet->maxlen;
+    memcpy(packet->data, t->inBuf[i], (size_t)len);
+    packet->len = len;
+    // sockaddr_in and IPaddress both keep host/port in network byte order
+    packet->address.host = t->inAddr[i].sin_addr.s_addr;
+    packet->address.port = t->inAddr[i].sin_port;
+    return 1;
+}
+
+static bool backend_send(Transport *t, IPaddress address, const void *data, int len) {
+    if (len > PACKET_BUFFER_SIZE) return false;
+    if (t->outCount >= TRANSPORT_BATCH_SIZE) backend_flush(t);
+
+    int i = t->outCount++;
+    memcpy(t->outBuf[i], data, (size_t)len);
+    t->outIov[i].iov_len = (size_t)len;
+    t->outAddr[i].sin_family      = AF_INET;
+    t->outAddr[i].sin_addr.s_addr = address.host;
+    t->outAddr[i].sin_port        = address.port;
+    return true;
+}
+
+static int backend_flush(Transport *t) {
+    if (t->outCount == 0) return 0;
+
+    // An error means the datagram at 'next' failed, the ones before it went out
+    int next = 0, sent = 0;
+    while (next < t->outCount) {
+        int n = sendmmsg(t->fd, &t->outMsgs[next], (unsigned int)(t->outCount - next), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                // Socket buffer full: drop the rest of the batch, UDP is lossy anyway
+                printf("Warn: sendmmsg dropped %d/%d datagrams: %s\n", t->outCount - next, t->outCount, strerror(errno));
+                break;
+            }
+            // One bad destination (e.g. EHOSTUNREACH): skip it, the other clients still get theirs
+            printf("Warn: sendmmsg failed for datagram %d/%d: %s\n", next + 1, t->outCount, strerror(errno));
+            next++;
+            continue;
+        }
+        next += n;
+        sent += n;
+    }
+    t->outCount = 0;
+    return sent;
+}
+
+int transport_fd(const Transport *t) {
+    return t ? t->fd : -1;
+}
+
+const char *transport_backend_name(const Transport *t) {
+    return "mmsg";
+}
+
+#else // Portable SDL_net fallback
+
+// Intern representation (SDL_net, one syscall per datagram)
+struct Transport {
+    UDPsocket socket;
+    UDPpacket *packet_out;
+    NetConditioner *condIn, *condOut; // NULL unless impairment is enabled
+};
+
+Transport *transport_open(Uint16 port) {
+    Transport *t = calloc(1, sizeof *t);
+    if (!t) {
+        perror("Failed to allocate transport");
+        return NULL;
+    }
+    t->socket = SDLNet_UDP_Open(port);
+    if (!t->socket) {
+        printf("SDLNet_UDP_Open Error: %s\n", SDLNet_GetError());
+        free(t);
+        return NULL;
+    }
+    t->packet_out = SDLNet_AllocPacket(PACKET_BUFFER_SIZE);
+    if (!t->packet_out) {
+        printf("SDLNet_AllocPacket Error: %s\n", SDLNet_GetError());
+        SDLNet_UDP_Close(t->socket);
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+static void backend_close(Transport *t) {
+    if (t->packet_out) SDLNet_FreePacket(t->packet_out);
+    if (t->socket)     SDLNet_UDP_Close(t->socket);
+}
+
+static int backend_recv(Transport *t, UDPpacket *packet) {
+    return SDLNet_UDP_Recv(t->socket, packet);
+}
+
+static bool backend_send(Transport *t, IPaddress address, const void *data, int len) {
+    if (len > t->packet_out->maxlen) return false;
+    t->packet_out->address = address;
+    t->packet_out->len     = len;
+    memcpy(t->packet_out->data, data, (size_t)len);
+    return SDLNet_UDP_Send(t->socket, -1, t->packet_out) != 0;
+}
+
+static int backend_flush(Transport *t) {
+    return 0; // Sends are immediate
+}
+
+int transport_fd(const Transport *t) {
+    return -1; // SDL_net does not expose its socket
+}
+
+const char *transport_backend_name(const Transport *t) {
+    return "sdlnet";
+}
+
+#endif
+
+// --- Common front end (optional network conditioner in both directions) ---
+
+void transport_close(Transport *t) {
+    if (!t) return;
+    backend_close(t);
+    netcond_destroy(t->condIn);
+    netcond_destroy(t->condOut);
+    free(t);
+}
+
+int transport_recv(Transport *t, UDPpacket *packet) {
+    if (!t || !packet) return -1;
+    if (!t->condIn) return backend_recv(t, packet);
+
+    // Everything waiting on the socket goes through the conditioner first
+    Uint32 now = SDL_GetTicks();
+    int rc;
+    while ((rc = backend_recv(t, packet)) > 0) {
+        netcond_push(t->condIn, packet->address, packet->data, packet->len, now);
+    }
+    if (rc < 0) return rc;
+
+    int len = 0;
+    IPaddress address;
+    const Uint8 *data = netcond_pop(t->condIn, now, &address, &len);
+    if (!data) return 0;
+    if (len > packet->maxlen) len = packet->maxlen;
+    memcpy(packet->data, data, (size_t)len);
+    packet->len     = len;
+    packet->address = address;
+    return 1;
+}
+
+bool transport_send(Transport *t, IPaddress address, const void *data, int len) {
+    if (!t || !data || len <= 0) return false;
+    if (t->condOut) {
+        netcond_push(t->condOut, address, data, len, SDL_GetTicks());
+        return true;
+    }
+    return backend_send(t, address, data, len);
+}
+
+int transport_flush(Transport *t) {
+    if (!t) return 0;
+    if (t->condOut) {
+        // Datagrams whose delay has run out join the outgoing batch
+        Uint32 now = SDL_GetTicks();
+        IPaddress address;
+        int len = 0;
+        const Uint8 *data;
+        while ((data = netcond_pop(t->condOut, now, &address, &len)) != NULL) {
+            backend_send(t, address, data, len);
+        }
+    }
+    return backend_flush(t);
+}
+
+bool transport_set_conditioner(Transport *t, const NetConditionerConfig *cfg) {
+    if (!t || !cfg) return false;
+    return netcond_create_pair(cfg, &t->condOut, &t->condIn);
+}